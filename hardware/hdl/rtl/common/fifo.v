@@ -70,8 +70,9 @@ module fifo #(
     assign almost_full = (count >= ALMOST_FULL_THRESHOLD);
     assign almost_empty = (count <= ALMOST_EMPTY_THRESHOLD);
     
-    // Qualified write/read enables
-    assign wr_en_qualified = wr_en && !full;
+    // Qualified write/read enables (a full FIFO takes a write in the same
+    // cycle as a read)
+    assign wr_en_qualified = wr_en && (!full || rd_en);
     assign rd_en_qualified = rd_en && !empty;
     
     // Write logic
@@ -105,7 +106,7 @@ module fifo #(
             overflow <= 1'b0;
             underflow <= 1'b0;
         end else begin
-            if (wr_en && full)
+            if (wr_en && !wr_en_qualified)
                 overflow <= 1'b1;
             if (rd_en && empty)
                 underflow <= 1'b1;
@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+// Title         : AXI-Stream State Dumper
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : state_dumper.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Streams a state table out as a stream_loader packet
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+// Emits the same packet format stream_loader accepts:
+//   beat 0      : {target[7:0], 24'd0}
+//   beat 1..N   : rd_data for addresses 0 .. count-1
+//   TLAST       : on the last data word
+// A DMA S2MM channel writes the packet to DDR as a snapshot; sending the
+// buffer back through the load stream (MM2S) restores it unchanged. The table
+// is read combinationally, so one word leaves per cycle while TREADY is high.
+
+module state_dumper #(
+    parameter DATA_WIDTH        = 32,
+    parameter ADDR_WIDTH        = 8
+)(
+    input  wire                         clk,
+    input  wire                         rst_n,
+    
+    // Control
+    input  wire                         start,          // Ignored while busy or count == 0
+    input  wire [7:0]                   target,
+    input  wire [ADDR_WIDTH:0]          count,
+    
+    // Table read port
+    output wire [ADDR_WIDTH-1:0]        rd_addr,
+    input  wire [DATA_WIDTH-1:0]        rd_data,
+    
+    // AXI4-Stream master (to DMA)
+    output wire [DATA_WIDTH-1:0]        m_axis_tdata,
+    output wire                         m_axis_tvalid,
+    input  wire                         m_axis_tready,
+    output wire                         m_axis_tlast,
+    
+    // Status
+    output wire                         dump_busy,
+    output reg                          dump_done       // One-cycle pulse per packet
+);
+
+    localparam IDLE   = 2'd0;
+    localparam HEADER = 2'd1;
+    localparam DATA   = 2'd2;
+    
+    reg [1:0] state;
+    reg [7:0] dump_target;
+    reg [ADDR_WIDTH:0] addr;
+    reg [ADDR_WIDTH:0] last_addr;
+    
+    assign rd_addr = addr[ADDR_WIDTH-1:0];
+    
+    assign m_axis_tvalid = (state != IDLE);
+    assign m_axis_tdata  = (state == HEADER) ? {dump_target, {(DATA_WIDTH-8){1'b0}}} : rd_data;
+    assign m_axis_tlast  = (state == DATA) && (addr == last_addr);
+    
+    assign dump_busy = (state != IDLE);
+    
+    wire beat = m_axis_tvalid && m_axis_tready;
+    
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            state <= IDLE;
+            dump_target <= 8'd0;
+            addr <= 0;
+            last_addr <= 0;
+            dump_done <= 1'b0;
+        end else begin
+            dump_done <= 1'b0;
+            
+            case (state)
+                IDLE: begin
+                    if (start && count != 0) begin
+                        state <= HEADER;
+                        dump_target <= target;
+                        addr <= 0;
+                        last_addr <= count - 1'b1;
+                    end
+                end
+                
+                HEADER: begin
+                    if (beat) begin
+                        state <= DATA;
+                    end
+                end
+                
+                DATA: begin
+                    if (beat) begin
+                        if (addr == last_addr) begin
+                            state <= IDLE;
+                            dump_done <= 1'b1;
+                        end else begin
+                            addr <= addr + 1'b1;
+                        end
+                    end
+                end
+                
+                default: state <= IDLE;
+            endcase
+        end
+    end
+
+endmodule
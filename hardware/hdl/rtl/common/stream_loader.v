@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+// Title         : AXI-Stream Bulk Loader
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : stream_loader.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Turns DMA packets into back-to-back table writes
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+// Packet format (one packet per table region):
+//   beat 0      : {target[7:0], base_addr[23:0]}
+//   beat 1..N   : data words, written to base_addr, base_addr+1, ...
+//   TLAST       : on the last data word
+// One write is issued per accepted beat, so a DMA engine fills a table at
+// full stream bandwidth. A header carrying TLAST (no data) flags an error.
+
+module stream_loader #(
+    parameter DATA_WIDTH        = 32,
+    parameter ADDR_WIDTH        = 24
+)(
+    input  wire                         clk,
+    input  wire                         rst_n,
+    
+    // AXI4-Stream slave (from DMA)
+    input  wire [DATA_WIDTH-1:0]        s_axis_tdata,
+    input  wire                         s_axis_tvalid,
+    output wire                         s_axis_tready,
+    input  wire                         s_axis_tlast,
+    
+    // Table write port
+    output reg                          wr_en,
+    output reg  [7:0]                   wr_target,
+    output reg  [ADDR_WIDTH-1:0]        wr_addr,
+    output reg  [DATA_WIDTH-1:0]        wr_data,
+    
+    // Completion status
+    output wire                         load_busy,
+    output reg                          load_done,      // One-cycle pulse per packet
+    output reg                          load_error,     // Last packet carried no data
+    output reg  [31:0]                  load_words      // Words written by the last packet
+);
+
+    localparam HEADER = 1'b0;
+    localparam DATA   = 1'b1;
+    
+    reg state;
+    reg [7:0] target;
+    reg [ADDR_WIDTH-1:0] next_addr;
+    reg [31:0] word_count;
+    
+    // Every beat becomes at most one write, so the stream never stalls
+    assign s_axis_tready = 1'b1;
+    
+    wire beat = s_axis_tvalid && s_axis_tready;
+    
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            state <= HEADER;
+            target <= 8'd0;
+            next_addr <= 0;
+            word_count <= 32'd0;
+            wr_en <= 1'b0;
+            wr_target <= 8'd0;
+            wr_addr <= 0;
+            wr_data <= 0;
+            load_done <= 1'b0;
+            load_error <= 1'b0;
+            load_words <= 32'd0;
+        end else begin
+            wr_en <= 1'b0;
+            load_done <= 1'b0;
+            
+            if (beat) begin
+                case (state)
+                    HEADER: begin
+                        target <= s_axis_tdata[DATA_WIDTH-1 -: 8];
+                        next_addr <= s_axis_tdata[ADDR_WIDTH-1:0];
+                        word_count <= 32'd0;
+                        
+                        if (s_axis_tlast) begin
+                            // Header-only packet: nothing to load
+                            load_done <= 1'b1;
+                            load_error <= 1'b1;
+                            load_words <= 32'd0;
+                        end else begin
+                            state <= DATA;
+                        end
+                    end
+                    
+                    DATA: begin
+                        wr_en <= 1'b1;
+                        wr_target <= target;
+                        wr_addr <= next_addr;
+                        wr_data <= s_axis_tdata;
+                        next_addr <= next_addr + 1'b1;
+                        word_count <= word_count + 1'b1;
+                        
+                        if (s_axis_tlast) begin
+                            state <= HEADER;
+                            load_done <= 1'b1;
+                            load_error <= 1'b0;
+                            load_words <= word_count + 1'b1;
+                        end
+                    end
+                endcase
+            end
+        end
+    end
+    
+    assign load_busy = (state == DATA) || wr_en;
+
+endmodule
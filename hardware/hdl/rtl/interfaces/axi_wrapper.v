@@ -64,6 +64,24 @@ module axi_wrapper #(
     input  wire [31:0]                      status_reg,
     input  wire [31:0]                      spike_count,
     
+    // Weight paging
+    output reg  [31:0]                      page_base,      // DDR address of weight row 0
+    input  wire [31:0]                      page_misses,
+    input  wire [31:0]                      page_stalls,
+    
+    // AER tile port statistics
+    input  wire [31:0]                      aer_exported,
+    input  wire [31:0]                      aer_imported,
+    input  wire [31:0]                      aer_returned,
+    
+    // Router overflow policy and overload statistics
+    output reg  [31:0]                      router_policy,  // [1:0] policy, [7:4] sample shift, [31:16] shed threshold
+    input  wire [31:0]                      router_drop_newest,
+    input  wire [31:0]                      router_drop_oldest,
+    input  wire [31:0]                      router_drop_sampled,
+    input  wire [31:0]                      router_stalls,
+    input  wire [15:0]                      router_peak,
+    
     // Spike Router Interface
     output wire                             spike_in_valid,
     output wire [7:0]                       spike_in_neuron_id,
@@ -82,10 +100,24 @@ module axi_wrapper #(
     localparam ADDR_STATUS      = 8'h04;  // Status register
     localparam ADDR_CONFIG      = 8'h08;  // Configuration register
     localparam ADDR_SPIKE_COUNT = 8'h0C;  // Spike counter
-    localparam ADDR_LEAK_RATE   = 8'h10;  // Leak rate
-    localparam ADDR_THRESHOLD   = 8'h14;  // Threshold
-    localparam ADDR_REFRAC      = 8'h18;  // Refractory period
+    localparam ADDR_LEAK_RATE   = 8'h10;  // Leak rate (shadow, applied by COMMIT)
+    localparam ADDR_THRESHOLD   = 8'h14;  // Threshold (shadow, applied by COMMIT)
+    localparam ADDR_REFRAC      = 8'h18;  // Refractory period (shadow, applied by COMMIT)
     localparam ADDR_VERSION     = 8'h1C;  // Version register
+    // 8'h20 is the top-level interrupt threshold (written when CONFIG[11] is set)
+    localparam ADDR_PAGE_BASE   = 8'h24;  // Weight paging: DDR base of the weight matrix
+    localparam ADDR_PAGE_MISSES = 8'h28;  // Weight paging: rows fetched on demand
+    localparam ADDR_PAGE_STALLS = 8'h2C;  // Weight paging: cycles spent waiting for a row
+    localparam ADDR_AER_EXPORTED = 8'h30; // AER: packets sent to other tiles
+    localparam ADDR_AER_IMPORTED = 8'h34; // AER: remote spikes delivered to this tile
+    localparam ADDR_AER_RETURNED = 8'h38; // AER: packets that came back undelivered
+    localparam ADDR_ROUTER_POLICY  = 8'h3C; // Router overflow policy
+    localparam ADDR_ROUTER_NEWEST  = 8'h40; // Router: arriving spikes dropped (FIFO full)
+    localparam ADDR_ROUTER_OLDEST  = 8'h44; // Router: queued spikes evicted
+    localparam ADDR_ROUTER_SAMPLED = 8'h48; // Router: spikes skipped by sampling
+    localparam ADDR_ROUTER_STALLS  = 8'h4C; // Router: cycles the neurons were held off
+    localparam ADDR_ROUTER_PEAK    = 8'h50; // Router: peak input FIFO occupancy
+    localparam ADDR_COMMIT         = 8'h54; // Shadow parameter commit
     
     localparam VERSION = 32'h20240100;  // Version 2024.01.00
     
@@ -107,6 +139,24 @@ module axi_wrapper #(
     wire slv_reg_wren;
     wire slv_reg_rden;
     
+    //-------------------------------------------------------------------------
+    // Shadow Parameter Registers
+    //-------------------------------------------------------------------------
+    // Host writes to LEAK_RATE/THRESHOLD/REFRAC land in the shadow copies and
+    // have no effect until COMMIT: writing 1 to COMMIT[0] copies all three
+    // into the live outputs together at the next frame boundary, the end of
+    // an input spike frame (TLAST accepted) or any cycle with CTRL[0] clear.
+    // So a running core picks up new parameters after its current frame, and
+    // a disabled one on the cycle after the COMMIT write. Reads return
+    // {live, shadow}; COMMIT reads back {commit count, 15'd0, pending}.
+    reg [15:0] leak_rate_shadow;
+    reg [15:0] threshold_shadow;
+    reg [15:0] refractory_shadow;
+    reg        commit_pending;
+    reg [15:0] commit_count;
+    
+    wire frame_boundary = (s_axis_tvalid && s_axis_tready && s_axis_tlast) || !ctrl_reg[0];
+    
     //-------------------------------------------------------------------------
     // AXI4-Lite Write Logic
     //-------------------------------------------------------------------------
@@ -168,8 +218,26 @@ module axi_wrapper #(
             leak_rate <= 16'd10;
             threshold <= 16'd1000;
             refractory_period <= 16'd20;
+            leak_rate_shadow <= 16'd10;
+            threshold_shadow <= 16'd1000;
+            refractory_shadow <= 16'd20;
+            commit_pending <= 1'b0;
+            commit_count <= 16'd0;
+            page_base <= 32'h00000000;
+            router_policy <= 32'h00000000;
         end else begin
-            if (slv_reg_wren) begin
+            // Commit shadow parameters atomically at a frame boundary
+            if (commit_pending && frame_boundary) begin
+                leak_rate <= leak_rate_shadow;
+                threshold <= threshold_shadow;
+                refractory_period <= refractory_shadow;
+                commit_pending <= 1'b0;
+                commit_count <= commit_count + 1'b1;
+            end
+            
+            // Registers live in region 0x0xxx only; the other regions carry
+            // weight/neuron/router writes whose low byte must not alias them
+            if (slv_reg_wren && (axi_awaddr[15:12] == 4'h0)) begin
                 case (axi_awaddr[7:0])
                     ADDR_CTRL: begin
                         for (integer byte_idx = 0; byte_idx < 4; byte_idx = byte_idx + 1) begin
@@ -184,16 +252,31 @@ module axi_wrapper #(
                         end
                     end
                     ADDR_LEAK_RATE: begin
-                        if (s_axi_wstrb[0]) leak_rate[7:0] <= s_axi_wdata[7:0];
-                        if (s_axi_wstrb[1]) leak_rate[15:8] <= s_axi_wdata[15:8];
+                        if (s_axi_wstrb[0]) leak_rate_shadow[7:0] <= s_axi_wdata[7:0];
+                        if (s_axi_wstrb[1]) leak_rate_shadow[15:8] <= s_axi_wdata[15:8];
                     end
                     ADDR_THRESHOLD: begin
-                        if (s_axi_wstrb[0]) threshold[7:0] <= s_axi_wdata[7:0];
-                        if (s_axi_wstrb[1]) threshold[15:8] <= s_axi_wdata[15:8];
+                        if (s_axi_wstrb[0]) threshold_shadow[7:0] <= s_axi_wdata[7:0];
+                        if (s_axi_wstrb[1]) threshold_shadow[15:8] <= s_axi_wdata[15:8];
                     end
                     ADDR_REFRAC: begin
-                        if (s_axi_wstrb[0]) refractory_period[7:0] <= s_axi_wdata[7:0];
-                        if (s_axi_wstrb[1]) refractory_period[15:8] <= s_axi_wdata[15:8];
+                        if (s_axi_wstrb[0]) refractory_shadow[7:0] <= s_axi_wdata[7:0];
+                        if (s_axi_wstrb[1]) refractory_shadow[15:8] <= s_axi_wdata[15:8];
+                    end
+                    ADDR_COMMIT: begin
+                        if (s_axi_wstrb[0] && s_axi_wdata[0]) commit_pending <= 1'b1;
+                    end
+                    ADDR_PAGE_BASE: begin
+                        for (integer byte_idx = 0; byte_idx < 4; byte_idx = byte_idx + 1) begin
+                            if (s_axi_wstrb[byte_idx])
+                                page_base[byte_idx*8 +: 8] <= s_axi_wdata[byte_idx*8 +: 8];
+                        end
+                    end
+                    ADDR_ROUTER_POLICY: begin
+                        for (integer byte_idx = 0; byte_idx < 4; byte_idx = byte_idx + 1) begin
+                            if (s_axi_wstrb[byte_idx])
+                                router_policy[byte_idx*8 +: 8] <= s_axi_wdata[byte_idx*8 +: 8];
+                        end
                     end
                 endcase
             end
@@ -251,10 +334,23 @@ module axi_wrapper #(
                     ADDR_STATUS:      axi_rdata <= status_reg;
                     ADDR_CONFIG:      axi_rdata <= config_reg;
                     ADDR_SPIKE_COUNT: axi_rdata <= spike_count;
-                    ADDR_LEAK_RATE:   axi_rdata <= {16'd0, leak_rate};
-                    ADDR_THRESHOLD:   axi_rdata <= {16'd0, threshold};
-                    ADDR_REFRAC:      axi_rdata <= {16'd0, refractory_period};
+                    ADDR_LEAK_RATE:   axi_rdata <= {leak_rate, leak_rate_shadow};
+                    ADDR_THRESHOLD:   axi_rdata <= {threshold, threshold_shadow};
+                    ADDR_REFRAC:      axi_rdata <= {refractory_period, refractory_shadow};
                     ADDR_VERSION:     axi_rdata <= VERSION;
+                    ADDR_COMMIT:      axi_rdata <= {commit_count, 15'd0, commit_pending};
+                    ADDR_PAGE_BASE:   axi_rdata <= page_base;
+                    ADDR_PAGE_MISSES: axi_rdata <= page_misses;
+                    ADDR_PAGE_STALLS: axi_rdata <= page_stalls;
+                    ADDR_AER_EXPORTED: axi_rdata <= aer_exported;
+                    ADDR_AER_IMPORTED: axi_rdata <= aer_imported;
+                    ADDR_AER_RETURNED: axi_rdata <= aer_returned;
+                    ADDR_ROUTER_POLICY:  axi_rdata <= router_policy;
+                    ADDR_ROUTER_NEWEST:  axi_rdata <= router_drop_newest;
+                    ADDR_ROUTER_OLDEST:  axi_rdata <= router_drop_oldest;
+                    ADDR_ROUTER_SAMPLED: axi_rdata <= router_drop_sampled;
+                    ADDR_ROUTER_STALLS:  axi_rdata <= router_stalls;
+                    ADDR_ROUTER_PEAK:    axi_rdata <= {16'd0, router_peak};
                     default:          axi_rdata <= 32'hDEADBEEF;
                 endcase
             end
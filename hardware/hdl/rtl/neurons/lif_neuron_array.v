@@ -17,29 +17,46 @@ module lif_neuron_array #(
     parameter THRESHOLD_WIDTH   = 16,
     parameter LEAK_WIDTH        = 8,
     parameter REFRAC_WIDTH      = 8,
+    parameter LEAK_PERIOD       = NUM_NEURONS / 4,  // Enabled cycles per leak tick
+    parameter LEAK_TIME_WIDTH   = 32,
+    parameter QUEUE_DEPTH       = 64,     // Output spike queue entries (power of two)
+    parameter ENQUEUE_WIDTH     = 4,      // Fired neurons moved into the queue per cycle
+    parameter BITMAP_OUTPUT     = 0,      // 1: one firing bitmap per leak tick instead of the queue
+    parameter INPUT_LANES       = 1,      // Synaptic events accepted per cycle
     parameter NEURON_ID_WIDTH   = $clog2(NUM_NEURONS)
 )(
     input  wire                         clk,
     input  wire                         rst_n,
     input  wire                         enable,
     
-    // Input spike interface (AXI-Stream compatible)
-    input  wire                         s_axis_spike_valid,
-    input  wire [NEURON_ID_WIDTH-1:0]  s_axis_spike_dest_id,
-    input  wire [WEIGHT_WIDTH-1:0]     s_axis_spike_weight,
-    input  wire                         s_axis_spike_exc_inh,  // 1: exc, 0: inh
-    output wire                         s_axis_spike_ready,
+    // Input spike interface (AXI-Stream compatible), one lane per event.
+    // Lanes of one beat must target distinct neurons.
+    input  wire [INPUT_LANES-1:0]                 s_axis_spike_valid,
+    input  wire [INPUT_LANES*NEURON_ID_WIDTH-1:0] s_axis_spike_dest_id,
+    input  wire [INPUT_LANES*WEIGHT_WIDTH-1:0]    s_axis_spike_weight,
+    input  wire [INPUT_LANES-1:0]                 s_axis_spike_exc_inh,  // 1: exc, 0: inh
+    output wire                                   s_axis_spike_ready,
     
     // Output spike interface
     output reg                          m_axis_spike_valid,
     output reg  [NEURON_ID_WIDTH-1:0]  m_axis_spike_neuron_id,
     input  wire                         m_axis_spike_ready,
     
+    // Bitmap output interface (BITMAP_OUTPUT = 1): neurons fired per tick
+    output reg                          m_axis_bitmap_valid,
+    output reg  [NUM_NEURONS-1:0]      m_axis_bitmap_data,
+    output reg  [LEAK_TIME_WIDTH-1:0]  m_axis_bitmap_timestep,
+    input  wire                         m_axis_bitmap_ready,
+    
     // Configuration interface (AXI-Lite would connect here)
     input  wire                         config_we,
     input  wire [NEURON_ID_WIDTH-1:0]  config_addr,
     input  wire [31:0]                 config_data,
     
+    // State snapshot read port (combinational; take snapshots while disabled)
+    input  wire [NEURON_ID_WIDTH-1:0]  state_rd_addr,
+    output wire [31:0]                 state_rd_data,
+    
     // Global neuron parameters
     input  wire [THRESHOLD_WIDTH-1:0]  global_threshold,
     input  wire [LEAK_WIDTH-1:0]       global_leak_rate,
@@ -50,202 +67,319 @@ module lif_neuron_array #(
     output wire                        array_busy
 );
 
-    // State machine states
-    localparam IDLE         = 3'd0;
-    localparam RECEIVE      = 3'd1;
-    localparam PROCESS      = 3'd2;
-    localparam UPDATE       = 3'd3;
-    localparam OUTPUT       = 3'd4;
-    
-    reg [2:0] state, next_state;
-    
-    // Neuron state memory (using BRAM)
+    // Neuron state, held in register arrays rather than BRAM. The READ stage
+    // lanes, the snapshot port and the configuration port read it
+    // combinationally (INPUT_LANES + 2 read ports); the WRITE BACK lanes and
+    // the configuration port write it (INPUT_LANES + 1 write ports).
+    // Cost at the default sizes: the arrays are 64 x (16 + 8 + 32) = 3584
+    // flip-flops whatever the lane count. Each lane adds 88 pipeline
+    // flip-flops, a 64:1 read mux 56 bits wide, one more write port on every
+    // state register and one 32 x 8 leak multiplier (leak_by). The snapshot
+    // and configuration ports share two further leak multipliers.
     reg [DATA_WIDTH-1:0]    membrane_potential [0:NUM_NEURONS-1];
     reg [REFRAC_WIDTH-1:0]  refractory_counter [0:NUM_NEURONS-1];
     reg [NUM_NEURONS-1:0]   spike_flags;
     
-    // Input spike buffer
-    reg                         spike_pending;
-    reg [NEURON_ID_WIDTH-1:0]  spike_dest;
-    reg [WEIGHT_WIDTH-1:0]     spike_weight;
-    reg                         spike_exc_inh;
+    // Lazy leak: every neuron leaks by global_leak_rate once per tick, but the
+    // step is only applied when the neuron is next touched, as one combined
+    // subtraction over the ticks since its last_update. Idle neurons cost no
+    // cycles or memory accesses. Stamps wrap after 2^LEAK_TIME_WIDTH ticks.
+    reg [LEAK_TIME_WIDTH-1:0] last_update [0:NUM_NEURONS-1];
+    reg [LEAK_TIME_WIDTH-1:0] leak_time;
+    reg [15:0]                leak_div;
+    
+    // Event pipeline: ACCEPT -> READ -> INTEGRATE / THRESHOLD / WRITE BACK.
+    // INPUT_LANES synaptic events enter per clock, each in its own lane of
+    // the pipeline; the neuron state is held in registers, so every lane has
+    // its own read and write port. Events to a neuron still in WRITE BACK
+    // take the result through the forwarding path, from whichever lane.
     
-    // Processing variables
-    reg [NEURON_ID_WIDTH-1:0]  process_idx;
-    reg [DATA_WIDTH-1:0]       current_potential;
-    reg [REFRAC_WIDTH-1:0]     current_refrac;
-    reg                         update_en;
+    // READ stage: accepted events, operands fetched on the next edge
+    reg [INPUT_LANES-1:0]      rd_valid;
+    reg [NEURON_ID_WIDTH-1:0]  rd_dest [0:INPUT_LANES-1];
+    reg [WEIGHT_WIDTH-1:0]     rd_weight [0:INPUT_LANES-1];
+    reg [INPUT_LANES-1:0]      rd_exc_inh;
+    
+    // WRITE BACK stage: events plus the neuron state they integrate into
+    reg [INPUT_LANES-1:0]      wb_valid;
+    reg [NEURON_ID_WIDTH-1:0]  wb_dest [0:INPUT_LANES-1];
+    reg [WEIGHT_WIDTH-1:0]     wb_weight [0:INPUT_LANES-1];
+    reg [INPUT_LANES-1:0]      wb_exc_inh;
+    reg [DATA_WIDTH-1:0]       wb_potential [0:INPUT_LANES-1];
+    reg [REFRAC_WIDTH-1:0]     wb_refrac [0:INPUT_LANES-1];
+    reg [LEAK_TIME_WIDTH-1:0]  wb_stamp [0:INPUT_LANES-1];   // Tick wb_potential was last leaked to
     
     // Output spike queue
-    reg [NEURON_ID_WIDTH-1:0]  spike_queue [0:15];  // 16-entry queue
-    reg [3:0]                  queue_wr_ptr;
-    reg [3:0]                  queue_rd_ptr;
-    reg [4:0]                  queue_count;
+    localparam QUEUE_PTR_WIDTH = $clog2(QUEUE_DEPTH);
+    
+    reg [NEURON_ID_WIDTH-1:0]  spike_queue [0:QUEUE_DEPTH-1];
+    reg [QUEUE_PTR_WIDTH-1:0]  queue_wr_ptr;
+    reg [QUEUE_PTR_WIDTH-1:0]  queue_rd_ptr;
+    reg [QUEUE_PTR_WIDTH:0]    queue_count;
+    
+    // Firing bitmap for the current tick (BITMAP_OUTPUT = 1)
+    reg [NUM_NEURONS-1:0]      bitmap_acc;
     
     // Statistics
     reg [31:0] total_spikes;
     assign spike_count = total_spikes;
     
-    // Control signals
-    assign s_axis_spike_ready = (state == IDLE) && !spike_pending;
-    assign array_busy = (state != IDLE);
+    // Control signals: the pipeline never stalls, so it takes an event
+    // every cycle the array is enabled
+    assign s_axis_spike_ready = enable;
+    assign array_busy = (|rd_valid) || (|wb_valid) || (queue_count != 0) || (|spike_flags) ||
+                        m_axis_bitmap_valid;
+    
+    // Leak by ticks * global_leak_rate, flooring at zero. Equal to applying
+    // the single-step leak once per tick, since each step floors at zero too.
+    function [DATA_WIDTH-1:0] leak_by;
+        input [DATA_WIDTH-1:0] v;
+        input [LEAK_TIME_WIDTH-1:0] ticks;
+        reg [LEAK_TIME_WIDTH+LEAK_WIDTH-1:0] total;
+        begin
+            total = ticks * global_leak_rate;
+            leak_by = (total < v) ? (v - total) : {DATA_WIDTH{1'b0}};
+        end
+    endfunction
     
-    // State machine
+    // Snapshot word: restore select, refractory counter, membrane potential.
+    // Written back through the configuration port it restores both fields.
+    // The potential read out has its owed leak applied.
+    assign state_rd_data[31:30] = 2'b10;
+    assign state_rd_data[29:16] = refractory_counter[state_rd_addr];
+    assign state_rd_data[15:0]  = (refractory_counter[state_rd_addr] != 0) ?
+                                  membrane_potential[state_rd_addr] :
+                                  leak_by(membrane_potential[state_rd_addr],
+                                          leak_time - last_update[state_rd_addr]);
+    
+    // Leak tick counter
     always @(posedge clk) begin
         if (!rst_n) begin
-            state <= IDLE;
-        end else begin
-            state <= next_state;
+            leak_div <= 16'd0;
+            leak_time <= 0;
+        end else if (enable) begin
+            if (leak_div == LEAK_PERIOD - 1) begin
+                leak_div <= 16'd0;
+                leak_time <= leak_time + 1'b1;
+            end else begin
+                leak_div <= leak_div + 1'b1;
+            end
         end
     end
     
+    //-------------------------------------------------------------------------
+    // LEAK / INTEGRATE / THRESHOLD (combinational on the WRITE BACK stage)
+    //-------------------------------------------------------------------------
+    reg [DATA_WIDTH-1:0]       wb_leaked [0:INPUT_LANES-1];
+    reg [DATA_WIDTH:0]         wb_sum [0:INPUT_LANES-1];
+    reg [DATA_WIDTH-1:0]       wb_integrated [0:INPUT_LANES-1];
+    reg [INPUT_LANES-1:0]      wb_fire;
+    reg [REFRAC_WIDTH-1:0]     wb_new_refrac [0:INPUT_LANES-1];
+    reg [DATA_WIDTH-1:0]       wb_new_potential [0:INPUT_LANES-1];
+    integer k;
+    
     always @(*) begin
-        next_state = state;
-        case (state)
-            IDLE: begin
-                if (spike_pending) begin
-                    next_state = PROCESS;
-                end else if (s_axis_spike_valid) begin
-                    next_state = RECEIVE;
-                end else if (queue_count > 0 && m_axis_spike_ready) begin
-                    next_state = OUTPUT;
-                end
-            end
+        for (k = 0; k < INPUT_LANES; k = k + 1) begin
+            // Refractory neurons do not leak, and the counter only changes on
+            // events, so a refractory neuron owes no leak for its idle ticks
+            wb_leaked[k] = leak_by(wb_potential[k], leak_time - wb_stamp[k]);
             
-            RECEIVE: begin
-                next_state = IDLE;
-            end
+            wb_sum[k] = wb_leaked[k] + wb_weight[k];
+            wb_integrated[k] = wb_exc_inh[k] ?
+                (wb_sum[k][DATA_WIDTH] ? {DATA_WIDTH{1'b1}} : wb_sum[k][DATA_WIDTH-1:0])   // Saturate
+                : ((wb_leaked[k] < wb_weight[k]) ? {DATA_WIDTH{1'b0}} : (wb_leaked[k] - wb_weight[k]));
+            wb_fire[k] = (wb_refrac[k] == 0) && (wb_integrated[k] >= global_threshold);
             
-            PROCESS: begin
-                next_state = UPDATE;
+            // Refractory neurons ignore input and count down once per event
+            if (wb_refrac[k] != 0) begin
+                wb_new_refrac[k] = wb_refrac[k] - 1'b1;
+                wb_new_potential[k] = wb_potential[k];
+            end else if (wb_fire[k]) begin
+                wb_new_refrac[k] = global_refrac_period;
+                wb_new_potential[k] = {DATA_WIDTH{1'b0}};
+            end else begin
+                wb_new_refrac[k] = {REFRAC_WIDTH{1'b0}};
+                wb_new_potential[k] = wb_integrated[k];
             end
-            
-            UPDATE: begin
-                next_state = IDLE;
-            end
-            
-            OUTPUT: begin
-                if (m_axis_spike_ready) begin
-                    next_state = IDLE;
-                end
-            end
-            
-            default: next_state = IDLE;
-        endcase
+        end
     end
     
-    // Input spike handling
-    always @(posedge clk) begin
-        if (!rst_n) begin
-            spike_pending <= 1'b0;
-            spike_dest <= 0;
-            spike_weight <= 0;
-            spike_exc_inh <= 1'b1;
-        end else begin
-            if (state == RECEIVE && s_axis_spike_valid) begin
-                spike_pending <= 1'b1;
-                spike_dest <= s_axis_spike_dest_id;
-                spike_weight <= s_axis_spike_weight;
-                spike_exc_inh <= s_axis_spike_exc_inh;
-            end else if (state == UPDATE) begin
-                spike_pending <= 1'b0;
+    //-------------------------------------------------------------------------
+    // READ with forwarding
+    //-------------------------------------------------------------------------
+    // Lanes of a beat target distinct neurons, so at most one WRITE BACK
+    // lane matches
+    reg [DATA_WIDTH-1:0]       rd_potential [0:INPUT_LANES-1];
+    reg [REFRAC_WIDTH-1:0]     rd_refrac [0:INPUT_LANES-1];
+    reg [LEAK_TIME_WIDTH-1:0]  rd_stamp [0:INPUT_LANES-1];
+    integer f, m;
+    
+    always @(*) begin
+        for (f = 0; f < INPUT_LANES; f = f + 1) begin
+            rd_potential[f] = membrane_potential[rd_dest[f]];
+            rd_refrac[f] = refractory_counter[rd_dest[f]];
+            rd_stamp[f] = last_update[rd_dest[f]];
+            for (m = 0; m < INPUT_LANES; m = m + 1) begin
+                if (wb_valid[m] && (wb_dest[m] == rd_dest[f])) begin
+                    rd_potential[f] = wb_new_potential[m];
+                    rd_refrac[f] = wb_new_refrac[m];
+                    rd_stamp[f] = leak_time;
+                end
             end
         end
     end
     
-    // Neuron processing
+    // Pipeline registers
+    integer t;
     always @(posedge clk) begin
         if (!rst_n) begin
-            update_en <= 1'b0;
-            current_potential <= 0;
-            current_refrac <= 0;
-        end else begin
-            update_en <= 1'b0;
+            rd_valid <= 0;
+            rd_exc_inh <= {INPUT_LANES{1'b1}};
+            wb_valid <= 0;
+            wb_exc_inh <= {INPUT_LANES{1'b1}};
+            for (t = 0; t < INPUT_LANES; t = t + 1) begin
+                rd_dest[t] <= 0;
+                rd_weight[t] <= 0;
+                wb_dest[t] <= 0;
+                wb_weight[t] <= 0;
+                wb_potential[t] <= 0;
+                wb_refrac[t] <= 0;
+                wb_stamp[t] <= 0;
+            end
+        end else if (enable) begin
+            // ACCEPT
+            rd_valid <= s_axis_spike_valid;
+            rd_exc_inh <= s_axis_spike_exc_inh;
+            
+            // READ
+            wb_valid <= rd_valid;
+            wb_exc_inh <= rd_exc_inh;
             
-            if (state == PROCESS && spike_pending) begin
-                // Read neuron state
-                current_potential <= membrane_potential[spike_dest];
-                current_refrac <= refractory_counter[spike_dest];
-                update_en <= 1'b1;
+            for (t = 0; t < INPUT_LANES; t = t + 1) begin
+                rd_dest[t] <= s_axis_spike_dest_id[t*NEURON_ID_WIDTH +: NEURON_ID_WIDTH];
+                rd_weight[t] <= s_axis_spike_weight[t*WEIGHT_WIDTH +: WEIGHT_WIDTH];
+                wb_dest[t] <= rd_dest[t];
+                wb_weight[t] <= rd_weight[t];
+                wb_potential[t] <= rd_potential[t];
+                wb_refrac[t] <= rd_refrac[t];
+                wb_stamp[t] <= rd_stamp[t];
             end
         end
     end
     
-    // Neuron state update
+    // Configuration write. Written neurons are stamped with the current tick;
+    // a refractory-only write first settles the leak the neuron already owes.
+    wire [DATA_WIDTH-1:0] config_settled = (refractory_counter[config_addr] != 0) ?
+                                           membrane_potential[config_addr] :
+                                           leak_by(membrane_potential[config_addr],
+                                                   leak_time - last_update[config_addr]);
+    
+    // Neuron state update. Write-back and configuration share one process;
+    // a configuration write to a neuron written back in the same cycle wins.
     integer i;
     always @(posedge clk) begin
         if (!rst_n) begin
             for (i = 0; i < NUM_NEURONS; i = i + 1) begin
                 membrane_potential[i] <= 0;
                 refractory_counter[i] <= 0;
+                last_update[i] <= 0;
             end
-            spike_flags <= 0;
-        end else if (enable) begin
-            // Update specific neuron
-            if (state == UPDATE && update_en) begin
-                if (current_refrac > 0) begin
-                    // In refractory period
-                    refractory_counter[spike_dest] <= current_refrac - 1'b1;
-                end else begin
-                    // Update membrane potential
-                    if (spike_exc_inh) begin
-                        // Excitatory
-                        if (current_potential + spike_weight < current_potential) begin
-                            // Overflow - saturate
-                            membrane_potential[spike_dest] <= {DATA_WIDTH{1'b1}};
-                        end else begin
-                            membrane_potential[spike_dest] <= current_potential + spike_weight;
-                        end
-                    end else begin
-                        // Inhibitory
-                        if (current_potential < spike_weight) begin
-                            membrane_potential[spike_dest] <= 0;
-                        end else begin
-                            membrane_potential[spike_dest] <= current_potential - spike_weight;
-                        end
-                    end
-                    
-                    // Check threshold
-                    if (membrane_potential[spike_dest] >= global_threshold) begin
-                        spike_flags[spike_dest] <= 1'b1;
-                        membrane_potential[spike_dest] <= 0;
-                        refractory_counter[spike_dest] <= global_refrac_period;
+        end else begin
+            // WRITE BACK
+            if (enable) begin
+                for (i = 0; i < INPUT_LANES; i = i + 1) begin
+                    if (wb_valid[i]) begin
+                        membrane_potential[wb_dest[i]] <= wb_new_potential[i];
+                        refractory_counter[wb_dest[i]] <= wb_new_refrac[i];
+                        last_update[wb_dest[i]] <= leak_time;
                     end
                 end
             end
             
-            // Global leak update (time-multiplexed)
-            for (i = 0; i < 4; i = i + 1) begin  // Process 4 neurons per cycle
-                if (refractory_counter[process_idx + i] == 0) begin
-                    if (membrane_potential[process_idx + i] > global_leak_rate) begin
-                        membrane_potential[process_idx + i] <= 
-                            membrane_potential[process_idx + i] - global_leak_rate;
-                    end else begin
-                        membrane_potential[process_idx + i] <= 0;
+            // CONFIGURATION (after write-back, so it takes priority)
+            if (config_we && config_addr < NUM_NEURONS) begin
+                case (config_data[31:30])
+                    2'b00: begin
+                        membrane_potential[config_addr] <= config_data[DATA_WIDTH-1:0];
+                        last_update[config_addr] <= leak_time;
                     end
-                end
+                    2'b01: begin
+                        membrane_potential[config_addr] <= config_settled;
+                        refractory_counter[config_addr] <= config_data[REFRAC_WIDTH-1:0];
+                        last_update[config_addr] <= leak_time;
+                    end
+                    2'b10: begin // Snapshot word (see state_rd_data)
+                        membrane_potential[config_addr] <= config_data[DATA_WIDTH-1:0];
+                        refractory_counter[config_addr] <= config_data[16 +: REFRAC_WIDTH];
+                        last_update[config_addr] <= leak_time;
+                    end
+                    default: ; // Reserved
+                endcase
             end
-            
-            // Clear spike flags that have been queued
-            if (spike_flags[queue_wr_ptr[3:0]] && queue_count < 16) begin
-                spike_flags[queue_wr_ptr[3:0]] <= 1'b0;
+        end
+    end
+    
+
+    //-------------------------------------------------------------------------
+    // Output: fired neurons
+    //-------------------------------------------------------------------------
+    // Neurons fired this cycle, one per lane at most, and their count
+    reg [NUM_NEURONS-1:0]      fire_onehot;
+    reg [$clog2(INPUT_LANES+1)-1:0] fire_count;
+    
+    integer c;
+    always @(*) begin
+        fire_onehot = {NUM_NEURONS{1'b0}};
+        fire_count = 0;
+        for (c = 0; c < INPUT_LANES; c = c + 1) begin
+            if (enable && wb_valid[c] && wb_fire[c]) begin
+                fire_onehot[wb_dest[c]] = 1'b1;
+                fire_count = fire_count + 1'b1;
             end
         end
     end
     
-    // Process index counter for leak updates
+    // Priority-encoder scan: take up to ENQUEUE_WIDTH of the lowest pending
+    // flags per cycle, limited by the free queue entries
+    reg [NEURON_ID_WIDTH-1:0]  enq_id [0:ENQUEUE_WIDTH-1];
+    reg [ENQUEUE_WIDTH-1:0]    enq_valid;
+    reg [NUM_NEURONS-1:0]      enq_taken;
+    reg [NUM_NEURONS-1:0]      scan_mask;
+    reg [QUEUE_PTR_WIDTH:0]    enq_count;
+    integer e, j;
+    
+    always @(*) begin
+        scan_mask = spike_flags;
+        enq_taken = {NUM_NEURONS{1'b0}};
+        enq_count = 0;
+        for (e = 0; e < ENQUEUE_WIDTH; e = e + 1) begin
+            enq_id[e] = 0;
+            for (j = NUM_NEURONS - 1; j >= 0; j = j - 1) begin
+                if (scan_mask[j]) enq_id[e] = j;
+            end
+            enq_valid[e] = (|scan_mask) && (queue_count + e < QUEUE_DEPTH);
+            if (enq_valid[e]) begin
+                scan_mask[enq_id[e]] = 1'b0;
+                enq_taken[enq_id[e]] = 1'b1;
+                enq_count = enq_count + 1'b1;
+            end
+        end
+    end
+    
+    // Pending flags: set on fire, cleared once queued. A neuron that fires
+    // again before its flag is taken produces one queued spike.
     always @(posedge clk) begin
         if (!rst_n) begin
-            process_idx <= 0;
-        end else begin
-            process_idx <= process_idx + 4;
-            if (process_idx >= NUM_NEURONS - 4) begin
-                process_idx <= 0;
-            end
+            spike_flags <= 0;
+        end else if (!BITMAP_OUTPUT) begin
+            spike_flags <= (spike_flags & ~enq_taken) | fire_onehot;
         end
     end
     
-    // Output spike queue management
+    // Spike queue
+    integer q;
+    wire queue_pop = m_axis_spike_ready && (queue_count > 0);
+    
     always @(posedge clk) begin
         if (!rst_n) begin
             queue_wr_ptr <= 0;
@@ -253,43 +387,61 @@ module lif_neuron_array #(
             queue_count <= 0;
             m_axis_spike_valid <= 1'b0;
             m_axis_spike_neuron_id <= 0;
-            total_spikes <= 0;
         end else begin
-            // Add spikes to queue
-            if (|spike_flags && queue_count < 16) begin
-                for (i = 0; i < NUM_NEURONS; i = i + 1) begin
-                    if (spike_flags[i] && queue_count < 16) begin
-                        spike_queue[queue_wr_ptr] <= i;
-                        queue_wr_ptr <= queue_wr_ptr + 1'b1;
-                        queue_count <= queue_count + 1'b1;
-                        total_spikes <= total_spikes + 1'b1;
-                        spike_flags[i] <= 1'b0;
-                    end
+            for (q = 0; q < ENQUEUE_WIDTH; q = q + 1) begin
+                if (enq_valid[q]) begin
+                    spike_queue[(queue_wr_ptr + q) % QUEUE_DEPTH] <= enq_id[q];
                 end
             end
+            queue_wr_ptr <= queue_wr_ptr + enq_count;
+            queue_count <= queue_count + enq_count - queue_pop;
             
             // Output spikes from queue
-            if (state == OUTPUT && m_axis_spike_ready && queue_count > 0) begin
+            if (queue_pop) begin
                 m_axis_spike_valid <= 1'b1;
                 m_axis_spike_neuron_id <= spike_queue[queue_rd_ptr];
                 queue_rd_ptr <= queue_rd_ptr + 1'b1;
-                queue_count <= queue_count - 1'b1;
             end else if (m_axis_spike_ready) begin
                 m_axis_spike_valid <= 1'b0;
             end
         end
     end
     
-    // Configuration write
+    // Bitmap output: at each leak tick the neurons fired during that tick
+    // leave as one word. If the previous word is still waiting, the bitmap
+    // keeps accumulating and leaves with the next tick.
+    wire                   leak_tick = enable && (leak_div == LEAK_PERIOD - 1);
+    wire [NUM_NEURONS-1:0] bitmap_next = bitmap_acc | fire_onehot;
+    
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            bitmap_acc <= 0;
+            m_axis_bitmap_valid <= 1'b0;
+            m_axis_bitmap_data <= 0;
+            m_axis_bitmap_timestep <= 0;
+        end else if (BITMAP_OUTPUT) begin
+            if (m_axis_bitmap_valid && m_axis_bitmap_ready) begin
+                m_axis_bitmap_valid <= 1'b0;
+            end
+            
+            if (leak_tick && (|bitmap_next) &&
+                (!m_axis_bitmap_valid || m_axis_bitmap_ready)) begin
+                m_axis_bitmap_valid <= 1'b1;
+                m_axis_bitmap_data <= bitmap_next;
+                m_axis_bitmap_timestep <= leak_time;
+                bitmap_acc <= 0;
+            end else begin
+                bitmap_acc <= bitmap_next;
+            end
+        end
+    end
+    
+    // Spike statistics (at most one neuron fires per lane and cycle)
     always @(posedge clk) begin
         if (!rst_n) begin
-            // Reset handled above
-        end else if (config_we && config_addr < NUM_NEURONS) begin
-            case (config_data[31:30])
-                2'b00: membrane_potential[config_addr] <= config_data[DATA_WIDTH-1:0];
-                2'b01: refractory_counter[config_addr] <= config_data[REFRAC_WIDTH-1:0];
-                default: ; // Reserved
-            endcase
+            total_spikes <= 0;
+        end else begin
+            total_spikes <= total_spikes + fire_count;
         end
     end
 
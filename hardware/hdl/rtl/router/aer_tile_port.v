@@ -0,0 +1,236 @@
+//-----------------------------------------------------------------------------
+// Title         : AER Tile Port
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : aer_tile_port.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Address-event link between accelerator tiles on a ring
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+module aer_tile_port #(
+    parameter NUM_NEURONS       = 64,
+    parameter NEURON_ID_WIDTH   = $clog2(NUM_NEURONS),
+    parameter AXON_ID_WIDTH     = 6,
+    parameter TILE_ID           = 0,       // This tile's position, 0 .. 15
+    parameter EXPORT_FIFO_DEPTH = 64
+)(
+    input  wire                         clk,
+    input  wire                         rst_n,
+    
+    // Local neuron spikes (tapped beside the spike router)
+    input  wire                         local_spike_valid,
+    input  wire [NEURON_ID_WIDTH-1:0]  local_spike_id,
+    output wire                         local_spike_ready,
+    
+    // Remote spikes for this tile, to the synapse input
+    output reg                          import_valid,
+    output reg  [AXON_ID_WIDTH-1:0]    import_axon,
+    input  wire                         import_ready,
+    
+    // AER ring input (from the previous tile)
+    input  wire [31:0]                 s_axis_aer_tdata,
+    input  wire                         s_axis_aer_tvalid,
+    output wire                         s_axis_aer_tready,
+    input  wire                         s_axis_aer_tlast,
+    
+    // AER ring output (to the next tile)
+    output wire [31:0]                 m_axis_aer_tdata,
+    output wire                         m_axis_aer_tvalid,
+    input  wire                         m_axis_aer_tready,
+    output wire                         m_axis_aer_tlast,
+    
+    // Export table configuration, one word per source neuron:
+    // [31:16] destination tile mask, [7:0] axon on the destination tiles
+    input  wire                         config_we,
+    input  wire [NEURON_ID_WIDTH-1:0]  config_addr,
+    input  wire [31:0]                 config_data,
+    
+    // Status
+    input  wire                         clear_counters,
+    output reg  [31:0]                 exported_count,  // Packets injected
+    output reg  [31:0]                 imported_count,  // Spikes delivered here
+    output reg  [31:0]                 returned_count,  // Packets back at their source
+    output wire                        port_busy
+);
+
+    // Packet format, one word per packet (tlast always set):
+    // [31:16] destination tile mask, [15:8] source tile, [7:0] axon
+    //
+    // A local spike whose export entry names other tiles is injected once;
+    // every tile on the ring delivers it if its mask bit is set, clears the
+    // bit and forwards the rest. A packet is retired when its mask runs out,
+    // or when it comes back to the source tile (a mask bit named a tile
+    // that is not on the ring). On a chain instead of a ring, tie the last
+    // tile's m_axis_aer_tready high.
+    localparam MAX_TILES = 16;
+    localparam [MAX_TILES-1:0] TILE_BIT = 1 << TILE_ID;
+    localparam [7:0] TILE_NUM = TILE_ID;
+    localparam ENTRY_WIDTH = MAX_TILES + AXON_ID_WIDTH;
+    
+    // Export table: remote fan-out of each local neuron
+    reg [ENTRY_WIDTH-1:0] export_table [0:NUM_NEURONS-1];
+    
+    integer i;
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            for (i = 0; i < NUM_NEURONS; i = i + 1)
+                export_table[i] <= 0;
+        end else if (config_we) begin
+            export_table[config_addr] <= {config_data[31:16] & ~TILE_BIT,
+                                          config_data[AXON_ID_WIDTH-1:0]};
+        end
+    end
+    
+    //-------------------------------------------------------------------------
+    // Export queue
+    //-------------------------------------------------------------------------
+    wire [ENTRY_WIDTH-1:0] local_entry = export_table[local_spike_id];
+    wire local_remote = |local_entry[AXON_ID_WIDTH +: MAX_TILES];
+    
+    wire export_full, export_empty;
+    wire export_rd_en;
+    wire [ENTRY_WIDTH-1:0] head_entry;
+    reg head_valid;
+    wire [7:0] head_axon = head_entry[AXON_ID_WIDTH-1:0];
+    
+    fifo #(
+        .DATA_WIDTH(ENTRY_WIDTH),
+        .DEPTH(EXPORT_FIFO_DEPTH)
+    ) export_fifo (
+        .clk(clk),
+        .rst_n(rst_n),
+        .wr_en(local_spike_valid && local_spike_ready && local_remote),
+        .wr_data(local_entry),
+        .full(export_full),
+        .rd_en(export_rd_en),
+        .rd_data(head_entry),
+        .empty(export_empty)
+    );
+    
+    // Spikes without remote targets pass straight through
+    assign local_spike_ready = !export_full;
+    
+    //-------------------------------------------------------------------------
+    // Ring input: deliver, forward or retire
+    //-------------------------------------------------------------------------
+    // The input sits behind a skid register so s_axis_aer_tready comes from
+    // a flop; otherwise tready would chain combinationally around the ring.
+    reg        in_valid;
+    reg [31:0] in_data;
+    reg        skid_valid;
+    reg [31:0] skid_data;
+    
+    reg        out_valid;
+    reg [31:0] out_data;
+    
+    wire out_free    = !out_valid || m_axis_aer_tready;
+    wire import_free = !import_valid || import_ready;
+    
+    wire [MAX_TILES-1:0] in_mask = in_data[31:16];
+    wire [7:0]           in_src  = in_data[15:8];
+    wire [MAX_TILES-1:0] in_rest = in_mask & ~TILE_BIT;
+    
+    wire in_returned = (in_src == TILE_NUM);
+    wire need_local  = !in_returned && (in_mask[TILE_ID] == 1'b1);
+    wire need_fwd    = !in_returned && (in_rest != 0);
+    
+    // A packet moves only when both of its destinations can take it
+    wire in_take = in_valid && (!need_local || import_free) && (!need_fwd || out_free);
+    wire forward = in_take && need_fwd;
+    
+    assign s_axis_aer_tready = !skid_valid;
+    wire in_accept = s_axis_aer_tvalid && !skid_valid;
+    
+    // Ring traffic has priority over new packets, so a full ring drains.
+    // A packet is injected only while this tile's input side is empty, or
+    // its packet leaves the ring this cycle: every injection keeps a bubble
+    // on the ring, so forwarded traffic can always move and the ring cannot
+    // fill up and deadlock under import backpressure.
+    wire in_clear = !skid_valid && (!in_valid || (in_take && !need_fwd));
+    wire inject = head_valid && out_free && !forward && in_clear;
+    
+    // Keep the FIFO head register full
+    assign export_rd_en = !export_empty && (!head_valid || inject);
+    
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            in_valid <= 1'b0;
+            in_data <= 32'd0;
+            skid_valid <= 1'b0;
+            skid_data <= 32'd0;
+        end else if (!in_valid || in_take) begin
+            if (skid_valid) begin
+                in_valid <= 1'b1;
+                in_data <= skid_data;
+                skid_valid <= 1'b0;
+            end else begin
+                in_valid <= in_accept;
+                if (in_accept)
+                    in_data <= s_axis_aer_tdata;
+            end
+        end else if (in_accept) begin
+            skid_valid <= 1'b1;
+            skid_data <= s_axis_aer_tdata;
+        end
+    end
+    
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            head_valid <= 1'b0;
+            out_valid <= 1'b0;
+            out_data <= 32'd0;
+            import_valid <= 1'b0;
+            import_axon <= 0;
+        end else begin
+            if (export_rd_en)
+                head_valid <= 1'b1;
+            else if (inject)
+                head_valid <= 1'b0;
+            
+            if (forward) begin
+                out_valid <= 1'b1;
+                out_data <= {in_rest, in_data[15:0]};
+            end else if (inject) begin
+                out_valid <= 1'b1;
+                out_data <= {head_entry[AXON_ID_WIDTH +: MAX_TILES], TILE_NUM, head_axon};
+            end else if (m_axis_aer_tready) begin
+                out_valid <= 1'b0;
+            end
+            
+            if (in_take && need_local) begin
+                import_valid <= 1'b1;
+                import_axon <= in_data[AXON_ID_WIDTH-1:0];
+            end else if (import_ready) begin
+                import_valid <= 1'b0;
+            end
+        end
+    end
+    
+    assign m_axis_aer_tdata  = out_data;
+    assign m_axis_aer_tvalid = out_valid;
+    assign m_axis_aer_tlast  = 1'b1;
+    
+    //-------------------------------------------------------------------------
+    // Statistics
+    //-------------------------------------------------------------------------
+    always @(posedge clk) begin
+        if (!rst_n || clear_counters) begin
+            exported_count <= 32'd0;
+            imported_count <= 32'd0;
+            returned_count <= 32'd0;
+        end else begin
+            if (inject)
+                exported_count <= exported_count + 1'b1;
+            if (in_take && need_local)
+                imported_count <= imported_count + 1'b1;
+            if (in_take && in_returned)
+                returned_count <= returned_count + 1'b1;
+        end
+    end
+    
+    assign port_busy = head_valid || !export_empty || in_valid || skid_valid ||
+                       out_valid || import_valid;
+
+endmodule
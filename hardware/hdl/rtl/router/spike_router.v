@@ -12,9 +12,14 @@
 module spike_router #(
     parameter NUM_NEURONS       = 64,
     parameter MAX_FANOUT        = 32,      // Max connections per neuron
+    parameter NUM_CONNECTIONS   = NUM_NEURONS * MAX_FANOUT, // Packed edge slots
+    parameter CONN_ADDR_WIDTH   = $clog2(NUM_CONNECTIONS),
+    parameter NUM_BANKS         = 1,       // Banks sharing the sources (see spike_router_banked)
     parameter WEIGHT_WIDTH      = 8,
     parameter NEURON_ID_WIDTH   = $clog2(NUM_NEURONS),
     parameter DELAY_WIDTH       = 8,
+    parameter MAX_DELAY         = 32,      // Timing wheel slots: delays 0 .. MAX_DELAY-1 (power of two, <= 2^DELAY_WIDTH)
+    parameter DELAY_SLOT_DEPTH  = 8,       // Delayed spikes held per wheel slot
     parameter FIFO_DEPTH        = 256
 )(
     input  wire                         clk,
@@ -38,72 +43,146 @@ module spike_router #(
     input  wire [31:0]                 config_data,
     output reg  [31:0]                 config_readdata,
     
+    // Overflow policy (see below)
+    input  wire [1:0]                  overflow_policy,
+    input  wire [3:0]                  sample_shift,    // Keep 1 in 2^shift spikes
+    input  wire [15:0]                 shed_threshold,  // FIFO level where sampling starts
+    
     // Status
+    input  wire                        clear_stats,
     output wire [31:0]                 routed_spike_count,
     output wire                        router_busy,
-    output wire                        fifo_overflow
+    output wire                        fifo_overflow,   // A spike was shed
+    output reg  [31:0]                 drop_newest_count,
+    output reg  [31:0]                 drop_oldest_count,
+    output reg  [31:0]                 drop_sampled_count,
+    output reg  [31:0]                 stall_cycles,
+    output reg  [15:0]                 peak_occupancy
 );
 
-    // State machine states
-    localparam IDLE         = 3'd0;
-    localparam FETCH_CONN   = 3'd1;
-    localparam CHECK_DELAY  = 3'd2;
-    localparam ROUTE_SPIKE  = 3'd3;
-    localparam NEXT_CONN    = 3'd4;
-    
-    reg [2:0] state, next_state;
+    // Fan-out pipeline: POP (FIFO read latency) -> ISSUE (one connection
+    // read per cycle) -> FETCH -> output register. The next source spike is
+    // popped while the current fan-out is still issuing, so back-to-back
+    // fan-outs run without bubbles. A stalled output holds every stage.
     
-    // Connection memory structure
+    // Connection memory structure: a packed edge array. The connections of
+    // neuron n are conn_memory[conn_base[n] .. conn_base[n] + conn_count[n] - 1],
+    // so rows take only as many slots as the neuron has connections.
     // Format: [valid(1), exc/inh(1), weight(8), delay(8), dest_id(6)] = 24 bits
     (* ram_style = "block" *)
-    reg [23:0] conn_memory [0:(NUM_NEURONS * MAX_FANOUT)-1];
+    reg [23:0] conn_memory [0:NUM_CONNECTIONS-1];
     
-    // Connection count per neuron
+    // Row base and connection count per neuron. Bases reset to
+    // (n / NUM_BANKS) * MAX_FANOUT, so a host that never writes them keeps
+    // the fixed-stride layout within each bank.
+    reg [CONN_ADDR_WIDTH-1:0] conn_base [0:NUM_NEURONS-1];
     reg [7:0] conn_count [0:NUM_NEURONS-1];
     
     // Spike event FIFO
     wire fifo_wr_en, fifo_rd_en;
     wire fifo_empty, fifo_full;
+    wire [$clog2(FIFO_DEPTH):0] fifo_count;
     wire [NEURON_ID_WIDTH-1:0] fifo_spike_id;
     wire [31:0] fifo_timestamp;
     reg [31:0] current_time;
     
-    // Processing registers
-    reg [NEURON_ID_WIDTH-1:0] current_neuron;
+    // Popped source spike waiting for its fan-out (FIFO rd_data)
+    reg head_valid;
+    
+    // Fan-out in progress
+    reg active;
+    reg [CONN_ADDR_WIDTH-1:0] current_base;
     reg [7:0] conn_index;
-    reg [23:0] current_conn;
+    reg [7:0] conn_end;
     reg [31:0] spike_timestamp;
     
+    // FETCH stage
+    reg fetch_valid;
+    reg [23:0] current_conn;
+    reg [31:0] fetch_timestamp;
+    
     // Output registers
     reg out_valid;
     reg [NEURON_ID_WIDTH-1:0] out_dest_id;
     reg [WEIGHT_WIDTH-1:0] out_weight;
     reg out_exc_inh;
     
+    // Timing wheel: a spike delayed by d is held in slot (t + d) mod
+    // MAX_DELAY and leaves when the wheel reaches that slot. The wheel time
+    // follows current_time, one slot per cycle, and drains a due slot at
+    // one spike per cycle; after a burst it lags and catches up over the
+    // following empty slots. A spike that does not fit (slot full, or due
+    // MAX_DELAY or more ahead of the wheel) is dropped and counted.
+    //
+    // The connection word has room for delays up to 2^DELAY_WIDTH - 1. A
+    // word whose delay the wheel cannot hold is refused when it is written:
+    // it is stored with its valid bit cleared and counted, so it never
+    // reaches the wheel.
+    localparam SLOT_WIDTH  = $clog2(MAX_DELAY);
+    localparam DEPTH_WIDTH = $clog2(DELAY_SLOT_DEPTH + 1);
+    localparam ENTRY_WIDTH = NEURON_ID_WIDTH + WEIGHT_WIDTH + 1;
+    
+    reg [ENTRY_WIDTH-1:0]  wheel_memory [0:(MAX_DELAY * DELAY_SLOT_DEPTH)-1];
+    reg [DEPTH_WIDTH-1:0]  slot_count [0:MAX_DELAY-1];
+    reg [31:0]             wheel_time;     // Time of the slot being drained
+    reg [DEPTH_WIDTH-1:0]  drain_index;
+    reg [15:0]             wheel_pending;  // Spikes held in the wheel
+    
     // Statistics
     reg [31:0] spike_counter;
+    reg [31:0] delayed_counter;            // Spikes scheduled on the wheel
+    reg [31:0] delay_overflow_counter;     // Delayed spikes dropped
+    reg [31:0] delay_reject_counter;       // Connection writes refused for their delay
     reg overflow_flag;
     
     //-------------------------------------------------------------------------
     // Input spike FIFO
     //-------------------------------------------------------------------------
+    // Overflow policies. BLOCK backpressures the neurons when the FIFO is
+    // full. The others always take the spike so the neuron array keeps
+    // pace, and shed load instead: DROP_NEWEST discards the arriving spike,
+    // DROP_OLDEST evicts the oldest waiting spike (the head register) to
+    // make room, and SAMPLE keeps one spike in 2^sample_shift once the FIFO
+    // holds shed_threshold or more, and drops the newest when full.
+    localparam POLICY_BLOCK       = 2'd0;
+    localparam POLICY_DROP_NEWEST = 2'd1;
+    localparam POLICY_DROP_OLDEST = 2'd2;
+    localparam POLICY_SAMPLE      = 2'd3;
+    
+    wire pop;
+    reg [15:0] sample_count;
+    
+    wire shedding = (overflow_policy != POLICY_BLOCK);
+    wire above_mark = (fifo_count >= shed_threshold);
+    wire sample_keep = ((sample_count & ((16'd1 << sample_shift) - 1'b1)) == 16'd0);
+    wire sampling = s_spike_valid && (overflow_policy == POLICY_SAMPLE) && above_mark;
+    wire sample_drop = sampling && !sample_keep;
+    
+    // The head register is replaced by the next FIFO entry, which frees a
+    // slot for the arriving spike in the same cycle
+    wire evict = s_spike_valid && (overflow_policy == POLICY_DROP_OLDEST) &&
+                 fifo_full && head_valid && !pop;
+    
+    wire room = !fifo_full || fifo_rd_en;
+    assign fifo_wr_en = s_spike_valid && s_spike_ready && !sample_drop && room;
+    wire drop_newest = s_spike_valid && shedding && !sample_drop && !room;
+    
     fifo #(
         .DATA_WIDTH(NEURON_ID_WIDTH + 32),
         .DEPTH(FIFO_DEPTH)
     ) spike_fifo (
         .clk(clk),
         .rst_n(rst_n),
-        .wr_en(s_spike_valid && s_spike_ready),
+        .wr_en(fifo_wr_en),
         .wr_data({current_time, s_spike_neuron_id}),
         .full(fifo_full),
         .rd_en(fifo_rd_en),
         .rd_data({fifo_timestamp, fifo_spike_id}),
         .empty(fifo_empty),
-        .overflow(fifo_overflow)
+        .count(fifo_count)
     );
     
-    assign s_spike_ready = !fifo_full;
-    assign fifo_rd_en = (state == IDLE) && !fifo_empty;
+    assign s_spike_ready = shedding || !fifo_full;
     
     // Global timestamp counter
     always @(posedge clk) begin
@@ -114,91 +193,146 @@ module spike_router #(
     end
     
     //-------------------------------------------------------------------------
-    // State machine
+    // Fan-out control
     //-------------------------------------------------------------------------
-    always @(posedge clk) begin
-        if (!rst_n)
-            state <= IDLE;
-        else
-            state <= next_state;
-    end
+    wire out_free = !out_valid || m_spike_ready;
     
-    always @(*) begin
-        next_state = state;
-        case (state)
-            IDLE: begin
-                if (!fifo_empty)
-                    next_state = FETCH_CONN;
-            end
+    // The wheel owns the output while a due slot holds spikes; delayed
+    // connections bypass the output, so only undelayed ones wait for it
+    wire [SLOT_WIDTH-1:0] wheel_slot = wheel_time[SLOT_WIDTH-1:0];
+    wire [31:0] wheel_lag = current_time - wheel_time;
+    wire wheel_due = !wheel_lag[31];
+    wire slot_left = (drain_index != slot_count[wheel_slot]);
+    wire drain = wheel_due && slot_left && out_free;
+    
+    // Connection in the FETCH stage: invalid, routed now, or put on the wheel
+    wire [31:0] conn_age = current_time - fetch_timestamp;
+    wire [31:0] conn_due = fetch_timestamp + current_conn[13:6];
+    wire [31:0] conn_ahead = conn_due - wheel_time;
+    wire [SLOT_WIDTH-1:0] conn_slot = conn_due[SLOT_WIDTH-1:0];
+    
+    wire conn_live = fetch_valid && current_conn[23];
+    wire route_conn = conn_live && (conn_age >= current_conn[13:6]);
+    wire delay_conn = conn_live && (conn_age < current_conn[13:6]);
+    wire delay_fits = (conn_ahead < MAX_DELAY) && (slot_count[conn_slot] < DELAY_SLOT_DEPTH);
+    wire schedule = delay_conn && delay_fits;
+    
+    // The FETCH stage empties unless its spike is waiting for the output
+    wire advance = !route_conn || (out_free && !drain);
+    wire issue = active && advance;
+    wire finishing = issue && (conn_index + 1'b1 >= conn_end);
+    
+    // The popped spike starts once the active fan-out issues its last read
+    wire start = head_valid && (!active || finishing);
+    wire [7:0] head_count = conn_count[fifo_spike_id];
+    
+    // Keep the FIFO head register full
+    assign pop = !fifo_empty && (!head_valid || start);
+    assign fifo_rd_en = pop || evict;
+    
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            head_valid <= 1'b0;
+            active <= 1'b0;
+            current_base <= 0;
+            conn_index <= 0;
+            conn_end <= 0;
+            spike_timestamp <= 0;
+        end else begin
+            if (fifo_rd_en)
+                head_valid <= 1'b1;
+            else if (start)
+                head_valid <= 1'b0;
             
-            FETCH_CONN: begin
-                next_state = CHECK_DELAY;
-            end
+            if (issue)
+                conn_index <= conn_index + 1'b1;
             
-            CHECK_DELAY: begin
-                if (current_conn[23] && // valid connection
-                    ((current_time - spike_timestamp) >= current_conn[13:6])) // delay expired
-                    next_state = ROUTE_SPIKE;
-                else
-                    next_state = NEXT_CONN;
+            if (start) begin
+                // Neurons without connections are dropped without a fan-out
+                active <= (head_count != 0);
+                current_base <= conn_base[fifo_spike_id];
+                spike_timestamp <= fifo_timestamp;
+                conn_index <= 0;
+                conn_end <= head_count;
+            end else if (finishing) begin
+                active <= 1'b0;
             end
-            
-            ROUTE_SPIKE: begin
-                if (m_spike_ready)
-                    next_state = NEXT_CONN;
+        end
+    end
+    
+    // FETCH: one connection memory read per issue
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            fetch_valid <= 1'b0;
+            fetch_timestamp <= 0;
+        end else if (advance) begin
+            fetch_valid <= issue;
+            fetch_timestamp <= spike_timestamp;
+        end
+    end
+    
+    always @(posedge clk) begin
+        if (issue)
+            current_conn <= conn_memory[current_base + conn_index];
+    end
+    
+    //-------------------------------------------------------------------------
+    // Timing wheel
+    //-------------------------------------------------------------------------
+    // Scheduled slots are always ahead of the slot being drained, so insert
+    // and drain never touch the same slot in one cycle
+    wire [ENTRY_WIDTH-1:0] drain_entry = wheel_memory[wheel_slot * DELAY_SLOT_DEPTH + drain_index];
+    wire slot_done = wheel_due && (!slot_left || (drain && drain_index + 1'b1 == slot_count[wheel_slot]));
+    
+    always @(posedge clk) begin
+        if (schedule)
+            wheel_memory[conn_slot * DELAY_SLOT_DEPTH + slot_count[conn_slot]] <=
+                {current_conn[22], current_conn[21:14], current_conn[5:0]};
+    end
+    
+    integer w;
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            for (w = 0; w < MAX_DELAY; w = w + 1) begin
+                slot_count[w] <= 0;
             end
+            wheel_time <= 32'd0;
+            drain_index <= 0;
+            wheel_pending <= 16'd0;
+        end else begin
+            if (schedule)
+                slot_count[conn_slot] <= slot_count[conn_slot] + 1'b1;
             
-            NEXT_CONN: begin
-                if (conn_index >= conn_count[current_neuron])
-                    next_state = IDLE;
-                else
-                    next_state = FETCH_CONN;
+            if (slot_done) begin
+                slot_count[wheel_slot] <= 0;
+                drain_index <= 0;
+                wheel_time <= wheel_time + 1'b1;
+            end else if (drain) begin
+                drain_index <= drain_index + 1'b1;
             end
             
-            default: next_state = IDLE;
-        endcase
+            wheel_pending <= wheel_pending + schedule - drain;
+        end
     end
     
-    //-------------------------------------------------------------------------
-    // Connection processing
-    //-------------------------------------------------------------------------
+    // Output: wheel spikes first, then undelayed connections
     always @(posedge clk) begin
         if (!rst_n) begin
-            current_neuron <= 0;
-            conn_index <= 0;
-            current_conn <= 0;
-            spike_timestamp <= 0;
             out_valid <= 1'b0;
-        end else begin
-            case (state)
-                IDLE: begin
-                    out_valid <= 1'b0;
-                    if (!fifo_empty) begin
-                        current_neuron <= fifo_spike_id;
-                        spike_timestamp <= fifo_timestamp;
-                        conn_index <= 0;
-                    end
-                end
-                
-                FETCH_CONN: begin
-                    current_conn <= conn_memory[current_neuron * MAX_FANOUT + conn_index];
-                end
-                
-                ROUTE_SPIKE: begin
-                    if (!out_valid || m_spike_ready) begin
-                        out_valid <= 1'b1;
-                        out_dest_id <= current_conn[5:0];
-                        out_weight <= current_conn[21:14];
-                        out_exc_inh <= current_conn[22];
-                        spike_counter <= spike_counter + 1'b1;
-                    end
-                end
-                
-                NEXT_CONN: begin
-                    out_valid <= 1'b0;
-                    conn_index <= conn_index + 1'b1;
-                end
-            endcase
+            out_dest_id <= 0;
+            out_weight <= 0;
+            out_exc_inh <= 1'b0;
+        end else if (out_free) begin
+            out_valid <= drain || route_conn;
+            if (drain) begin
+                out_dest_id <= drain_entry[NEURON_ID_WIDTH-1:0];
+                out_weight <= drain_entry[NEURON_ID_WIDTH +: WEIGHT_WIDTH];
+                out_exc_inh <= drain_entry[ENTRY_WIDTH-1];
+            end else begin
+                out_dest_id <= current_conn[5:0];
+                out_weight <= current_conn[21:14];
+                out_exc_inh <= current_conn[22];
+            end
         end
     end
     
@@ -211,43 +345,112 @@ module spike_router #(
     //-------------------------------------------------------------------------
     // Configuration interface
     //-------------------------------------------------------------------------
+    wire config_conn = config_we && (config_addr[31:24] == 8'h00);
+    wire config_delay_fits = (config_data[6 +: DELAY_WIDTH] < MAX_DELAY);
+    
     always @(posedge clk) begin
         if (!rst_n) begin
-            // Initialize connection counts
+            // Initialize connection counts and fixed-stride row bases
             for (integer i = 0; i < NUM_NEURONS; i = i + 1) begin
                 conn_count[i] <= 8'd0;
+                conn_base[i] <= (i / NUM_BANKS) * MAX_FANOUT;
             end
-            spike_counter <= 32'd0;
         end else if (config_we) begin
             case (config_addr[31:24])
-                8'h00: begin // Write connection
-                    conn_memory[config_addr[15:0]] <= config_data[23:0];
+                8'h00: begin // Write connection, disabled if its delay is past the wheel
+                    conn_memory[config_addr[15:0]] <= {config_data[23] && config_delay_fits,
+                                                       config_data[22:0]};
                 end
                 8'h01: begin // Write connection count
                     conn_count[config_addr[7:0]] <= config_data[7:0];
                 end
-                8'h02: begin // Reset statistics
-                    if (config_data[0])
-                        spike_counter <= 32'd0;
+                8'h03: begin // Write row base
+                    conn_base[config_addr[7:0]] <= config_data[CONN_ADDR_WIDTH-1:0];
                 end
             endcase
         end
     end
     
+    // Routed spike counter (config 8'h02 clears it)
+    always @(posedge clk) begin
+        if (!rst_n)
+            spike_counter <= 32'd0;
+        else if (config_we && config_addr[31:24] == 8'h02 && config_data[0])
+            spike_counter <= 32'd0;
+        else if (out_free && (drain || route_conn))
+            spike_counter <= spike_counter + 1'b1;
+    end
+    
+    // Delay statistics, cleared with the routed spike counter
+    always @(posedge clk) begin
+        if (!rst_n || (config_we && config_addr[31:24] == 8'h02 && config_data[0])) begin
+            delayed_counter <= 32'd0;
+            delay_overflow_counter <= 32'd0;
+            delay_reject_counter <= 32'd0;
+        end else begin
+            if (schedule)
+                delayed_counter <= delayed_counter + 1'b1;
+            if (delay_conn && !delay_fits)
+                delay_overflow_counter <= delay_overflow_counter + 1'b1;
+            if (config_conn && config_data[23] && !config_delay_fits)
+                delay_reject_counter <= delay_reject_counter + 1'b1;
+        end
+    end
+    
+    // Overload statistics, cleared with the routed spike counter
+    always @(posedge clk) begin
+        if (!rst_n || clear_stats || (config_we && config_addr[31:24] == 8'h02 && config_data[0])) begin
+            drop_newest_count <= 32'd0;
+            drop_oldest_count <= 32'd0;
+            drop_sampled_count <= 32'd0;
+            stall_cycles <= 32'd0;
+            peak_occupancy <= 16'd0;
+            sample_count <= 16'd0;
+            overflow_flag <= 1'b0;
+        end else begin
+            if (drop_newest)
+                drop_newest_count <= drop_newest_count + 1'b1;
+            if (evict)
+                drop_oldest_count <= drop_oldest_count + 1'b1;
+            if (sample_drop)
+                drop_sampled_count <= drop_sampled_count + 1'b1;
+            if (s_spike_valid && !s_spike_ready)
+                stall_cycles <= stall_cycles + 1'b1;
+            if (fifo_count > peak_occupancy)
+                peak_occupancy <= fifo_count;
+            if (sampling)
+                sample_count <= sample_count + 1'b1;
+            if (drop_newest || evict || sample_drop)
+                overflow_flag <= 1'b1;
+        end
+    end
+    
+    assign fifo_overflow = overflow_flag;
+    
     // Configuration read
     always @(*) begin
         config_readdata = 32'd0;
         case (config_addr[31:24])
             8'h00: config_readdata = {8'd0, conn_memory[config_addr[15:0]]};
             8'h01: config_readdata = {24'd0, conn_count[config_addr[7:0]]};
+            8'h03: config_readdata = conn_base[config_addr[7:0]];
             8'h10: config_readdata = spike_counter;
             8'h11: config_readdata = {31'd0, fifo_overflow};
+            8'h12: config_readdata = delayed_counter;
+            8'h13: config_readdata = delay_overflow_counter;
+            8'h14: config_readdata = drop_newest_count;
+            8'h15: config_readdata = drop_oldest_count;
+            8'h16: config_readdata = drop_sampled_count;
+            8'h17: config_readdata = stall_cycles;
+            8'h18: config_readdata = {16'd0, peak_occupancy};
+            8'h19: config_readdata = delay_reject_counter;
             default: config_readdata = 32'hDEADBEEF;
         endcase
     end
     
     // Status outputs
     assign routed_spike_count = spike_counter;
-    assign router_busy = (state != IDLE) || !fifo_empty;
+    assign router_busy = head_valid || active || fetch_valid || out_valid || !fifo_empty ||
+                         (wheel_pending != 0);
 
 endmodule
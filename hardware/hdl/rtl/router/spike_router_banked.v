@@ -0,0 +1,215 @@
+//-----------------------------------------------------------------------------
+// Title         : Multi-Bank Spike Router
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : spike_router_banked.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Parallel spike_router banks merged onto a multi-lane output
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+// Source neuron n is routed by bank n % NUM_BANKS, which has its own input
+// FIFO, connection memory and timing wheel, so spikes from different banks
+// fan out in parallel. A round-robin arbiter grants up to OUT_LANES bank
+// outputs per cycle; with OUT_LANES = NUM_BANKS every bank emits every
+// cycle. Unlike synapse_array beats, lanes of one beat may share a
+// destination neuron.
+//
+// Configuration keeps the spike_router map. Counts (8'h01) and row bases
+// (8'h03) are addressed by global neuron id and land in the owning bank;
+// connection words (8'h00) and statistics (8'h02, 8'h1x) address the bank
+// in config_addr[23:16].
+
+module spike_router_banked #(
+    parameter NUM_NEURONS       = 64,
+    parameter MAX_FANOUT        = 32,
+    parameter WEIGHT_WIDTH      = 8,
+    parameter NEURON_ID_WIDTH   = $clog2(NUM_NEURONS),
+    parameter NUM_BANKS         = 2,       // Power of two
+    parameter OUT_LANES         = NUM_BANKS,
+    parameter NUM_CONNECTIONS   = NUM_NEURONS * MAX_FANOUT, // Total over all banks
+    parameter MAX_DELAY         = 32,
+    parameter DELAY_SLOT_DEPTH  = 8,
+    parameter FIFO_DEPTH        = 256      // Per bank
+)(
+    input  wire                         clk,
+    input  wire                         rst_n,
+    
+    // Input spike interface from neurons
+    input  wire                         s_spike_valid,
+    input  wire [NEURON_ID_WIDTH-1:0]  s_spike_neuron_id,
+    output wire                         s_spike_ready,
+    
+    // Output spike lanes to synapses
+    output reg  [OUT_LANES-1:0]                 m_spike_valid,
+    output reg  [OUT_LANES*NEURON_ID_WIDTH-1:0] m_spike_dest_id,
+    output reg  [OUT_LANES*WEIGHT_WIDTH-1:0]    m_spike_weight,
+    output reg  [OUT_LANES-1:0]                 m_spike_exc_inh,
+    input  wire                                  m_spike_ready,
+    
+    // Configuration interface (from AXI)
+    input  wire                         config_we,
+    input  wire [31:0]                 config_addr,
+    input  wire [31:0]                 config_data,
+    output wire [31:0]                 config_readdata,
+    
+    // Overflow policy, shared by all banks
+    input  wire [1:0]                  overflow_policy,
+    input  wire [3:0]                  sample_shift,
+    input  wire [15:0]                 shed_threshold,
+    
+    // Status
+    input  wire                        clear_stats,
+    output reg  [31:0]                 routed_spike_count,
+    output wire                        router_busy,
+    output wire                        fifo_overflow,
+    output reg  [31:0]                 drop_newest_count,   // Sums over all banks
+    output reg  [31:0]                 drop_oldest_count,
+    output reg  [31:0]                 drop_sampled_count,
+    output reg  [31:0]                 stall_cycles,
+    output reg  [15:0]                 peak_occupancy       // Deepest bank FIFO
+);
+
+    localparam BANK_WIDTH = (NUM_BANKS > 1) ? $clog2(NUM_BANKS) : 1;
+    
+    // Bank of a source neuron
+    wire [BANK_WIDTH-1:0] spike_bank = s_spike_neuron_id % NUM_BANKS;
+    
+    // Configuration target bank: by neuron id for per-neuron tables. A
+    // single bank ignores the bank field, so a stray bit cannot select a
+    // bank that does not exist.
+    wire neuron_table = (config_addr[31:24] == 8'h01) || (config_addr[31:24] == 8'h03);
+    wire [BANK_WIDTH-1:0] config_bank = (NUM_BANKS == 1) ? {BANK_WIDTH{1'b0}} :
+                                        neuron_table ? (config_addr[7:0] % NUM_BANKS) :
+                                                       config_addr[16 +: BANK_WIDTH];
+    
+    // Bank outputs
+    wire [NUM_BANKS-1:0]       bank_in_ready;
+    wire [NUM_BANKS-1:0]       bank_valid;
+    wire [NEURON_ID_WIDTH-1:0] bank_dest [0:NUM_BANKS-1];
+    wire [WEIGHT_WIDTH-1:0]    bank_weight [0:NUM_BANKS-1];
+    wire [NUM_BANKS-1:0]       bank_exc_inh;
+    reg  [NUM_BANKS-1:0]       bank_grant;
+    wire [31:0]                bank_readdata [0:NUM_BANKS-1];
+    wire [31:0]                bank_count [0:NUM_BANKS-1];
+    wire [NUM_BANKS-1:0]       bank_busy;
+    wire [NUM_BANKS-1:0]       bank_overflow;
+    wire [31:0]                bank_drop_newest [0:NUM_BANKS-1];
+    wire [31:0]                bank_drop_oldest [0:NUM_BANKS-1];
+    wire [31:0]                bank_drop_sampled [0:NUM_BANKS-1];
+    wire [31:0]                bank_stalls [0:NUM_BANKS-1];
+    wire [15:0]                bank_peak [0:NUM_BANKS-1];
+    
+    assign s_spike_ready = bank_in_ready[spike_bank];
+    
+    genvar b;
+    generate
+        for (b = 0; b < NUM_BANKS; b = b + 1) begin : bank
+            spike_router #(
+                .NUM_NEURONS(NUM_NEURONS),
+                .MAX_FANOUT(MAX_FANOUT),
+                .WEIGHT_WIDTH(WEIGHT_WIDTH),
+                .NEURON_ID_WIDTH(NEURON_ID_WIDTH),
+                .NUM_CONNECTIONS(NUM_CONNECTIONS / NUM_BANKS),
+                .NUM_BANKS(NUM_BANKS),
+                .MAX_DELAY(MAX_DELAY),
+                .DELAY_SLOT_DEPTH(DELAY_SLOT_DEPTH),
+                .FIFO_DEPTH(FIFO_DEPTH)
+            ) router_inst (
+                .clk(clk),
+                .rst_n(rst_n),
+                
+                .s_spike_valid(s_spike_valid && (spike_bank == b)),
+                .s_spike_neuron_id(s_spike_neuron_id),
+                .s_spike_ready(bank_in_ready[b]),
+                
+                .m_spike_valid(bank_valid[b]),
+                .m_spike_dest_id(bank_dest[b]),
+                .m_spike_weight(bank_weight[b]),
+                .m_spike_exc_inh(bank_exc_inh[b]),
+                .m_spike_ready(bank_grant[b]),
+                
+                .config_we(config_we && (config_bank == b)),
+                .config_addr(config_addr),
+                .config_data(config_data),
+                .config_readdata(bank_readdata[b]),
+                
+                .overflow_policy(overflow_policy),
+                .sample_shift(sample_shift),
+                .shed_threshold(shed_threshold),
+                
+                .clear_stats(clear_stats),
+                .routed_spike_count(bank_count[b]),
+                .router_busy(bank_busy[b]),
+                .fifo_overflow(bank_overflow[b]),
+                .drop_newest_count(bank_drop_newest[b]),
+                .drop_oldest_count(bank_drop_oldest[b]),
+                .drop_sampled_count(bank_drop_sampled[b]),
+                .stall_cycles(bank_stalls[b]),
+                .peak_occupancy(bank_peak[b])
+            );
+        end
+    endgenerate
+    
+    assign config_readdata = bank_readdata[config_bank];
+    assign router_busy = |bank_busy;
+    assign fifo_overflow = |bank_overflow;
+    
+    //-------------------------------------------------------------------------
+    // Output arbiter: round-robin over banks, up to OUT_LANES grants a cycle
+    //-------------------------------------------------------------------------
+    reg [BANK_WIDTH-1:0] rr_ptr;
+    reg [BANK_WIDTH-1:0] pick;
+    integer k, taken;
+    
+    always @(*) begin
+        bank_grant = {NUM_BANKS{1'b0}};
+        m_spike_valid = {OUT_LANES{1'b0}};
+        m_spike_dest_id = 0;
+        m_spike_weight = 0;
+        m_spike_exc_inh = 0;
+        taken = 0;
+        for (k = 0; k < NUM_BANKS; k = k + 1) begin
+            pick = (rr_ptr + k) % NUM_BANKS;
+            if (bank_valid[pick] && taken < OUT_LANES) begin
+                m_spike_valid[taken] = 1'b1;
+                m_spike_dest_id[taken*NEURON_ID_WIDTH +: NEURON_ID_WIDTH] = bank_dest[pick];
+                m_spike_weight[taken*WEIGHT_WIDTH +: WEIGHT_WIDTH] = bank_weight[pick];
+                m_spike_exc_inh[taken] = bank_exc_inh[pick];
+                bank_grant[pick] = m_spike_ready;
+                taken = taken + 1;
+            end
+        end
+    end
+    
+    // Rotate the first bank by the lanes served, so no bank is starved
+    // when more banks are valid than there are lanes
+    always @(posedge clk) begin
+        if (!rst_n)
+            rr_ptr <= 0;
+        else if (m_spike_ready && (|bank_valid))
+            rr_ptr <= (rr_ptr + OUT_LANES) % NUM_BANKS;
+    end
+    
+    // Routed spikes and overload statistics over all banks
+    integer c;
+    always @(*) begin
+        routed_spike_count = 32'd0;
+        drop_newest_count = 32'd0;
+        drop_oldest_count = 32'd0;
+        drop_sampled_count = 32'd0;
+        stall_cycles = 32'd0;
+        peak_occupancy = 16'd0;
+        for (c = 0; c < NUM_BANKS; c = c + 1) begin
+            routed_spike_count = routed_spike_count + bank_count[c];
+            drop_newest_count = drop_newest_count + bank_drop_newest[c];
+            drop_oldest_count = drop_oldest_count + bank_drop_oldest[c];
+            drop_sampled_count = drop_sampled_count + bank_drop_sampled[c];
+            stall_cycles = stall_cycles + bank_stalls[c];
+            if (bank_peak[c] > peak_occupancy)
+                peak_occupancy = bank_peak[c];
+        end
+    end
+
+endmodule
@@ -13,8 +13,17 @@ module synapse_array #(
     parameter NUM_AXONS         = 64,      // Number of input axons
     parameter NUM_NEURONS       = 64,      // Number of output neurons  
     parameter WEIGHT_WIDTH      = 8,       // Bits per weight
+    parameter WEIGHT_PRECISION  = 0,       // Stored codes: 0 = 8-bit, 1 = 4-bit, 2 = ternary
+    parameter SCALE_WIDTH       = 3,       // Per-axon scale (left shift of stored code)
+    parameter SPARSE            = 0,       // 0: dense axon x neuron, 1: CSR synapse list
+    parameter NUM_EDGES         = NUM_AXONS * NUM_NEURONS, // Synapse slots in memory
     parameter AXON_ID_WIDTH     = $clog2(NUM_AXONS),
     parameter NEURON_ID_WIDTH   = $clog2(NUM_NEURONS),
+    parameter EDGE_ADDR_WIDTH   = $clog2(NUM_EDGES),
+    parameter READ_LANES        = 1,       // Synapses delivered per beat (power of two)
+    parameter PAGED             = 0,       // Dense only: 1 = rows paged in from DDR on demand
+    parameter NUM_PAGES         = 8,       // Resident rows when paged (power of two, > PREFETCH_DEPTH)
+    parameter PREFETCH_DEPTH    = 4,       // Paged: spikes queued behind the fan-out, rows fetched ahead
     parameter USE_BRAM          = 1        // Use BRAM (1) or distributed RAM (0)
 )(
     input  wire                         clk,
@@ -23,12 +32,15 @@ module synapse_array #(
     // Input spike from axons
     input  wire                         spike_in_valid,
     input  wire [AXON_ID_WIDTH-1:0]    spike_in_axon_id,
+    output wire                         spike_in_ready,
     
-    // Output spikes to neurons
-    output reg                          spike_out_valid,
-    output reg  [NEURON_ID_WIDTH-1:0]  spike_out_neuron_id,
-    output reg  [WEIGHT_WIDTH-1:0]     spike_out_weight,
-    output reg                          spike_out_exc_inh,    // Sign bit
+    // Output spikes to neurons, one lane per synapse of the beat. Lanes of
+    // a beat always target distinct neurons.
+    output reg  [READ_LANES-1:0]                 spike_out_valid,
+    output reg  [READ_LANES*NEURON_ID_WIDTH-1:0] spike_out_neuron_id,
+    output reg  [READ_LANES*WEIGHT_WIDTH-1:0]    spike_out_weight,
+    output reg  [READ_LANES-1:0]                 spike_out_exc_inh,    // Sign bits
+    input  wire                                  spike_out_ready,
     
     // Weight configuration interface
     input  wire                         weight_we,
@@ -36,118 +48,510 @@ module synapse_array #(
     input  wire [NEURON_ID_WIDTH-1:0]  weight_addr_neuron,
     input  wire [WEIGHT_WIDTH:0]        weight_data,           // Includes sign
     
+    // Per-axon scale configuration (low-precision modes)
+    input  wire                         scale_we,
+    input  wire [AXON_ID_WIDTH-1:0]    scale_addr_axon,
+    input  wire [SCALE_WIDTH-1:0]      scale_data,
+    
+    // Sparse (CSR) configuration interface
+    input  wire                         edge_we,
+    input  wire [EDGE_ADDR_WIDTH-1:0]  edge_addr,
+    input  wire [NEURON_ID_WIDTH+WEIGHT_WIDTH:0] edge_data,   // {dest_id, sign, weight}
+    input  wire                         row_ptr_we,
+    input  wire [AXON_ID_WIDTH:0]      row_ptr_addr,
+    input  wire [EDGE_ADDR_WIDTH:0]    row_ptr_data,
+    
+    // Weight paging (PAGED = 1): row requests to DDR, row data back as
+    // packed {sign, code} entries, neuron 0 in the low bits of the first word
+    output reg                          page_req_valid,
+    output reg  [AXON_ID_WIDTH-1:0]    page_req_axon,
+    input  wire                         page_req_ready,
+    input  wire                         page_fill_valid,
+    input  wire [31:0]                 page_fill_data,
+    output wire                         page_fill_ready,
+    output wire                         page_miss,             // Row requested for a spike
+    output wire                         page_stall,            // Fan-out idle waiting for a row
+    
     // Control
     input  wire                         enable
 );
 
-    // State machine for sequential neuron processing
-    localparam IDLE     = 2'd0;
-    localparam FETCH    = 2'd1;
-    localparam DELIVER  = 2'd2;
+    // Stored code magnitude width: 8-bit, 4-bit (sign + 3) or ternary (sign + 1)
+    localparam CODE_WIDTH = (WEIGHT_PRECISION == 2) ? 1 :
+                            (WEIGHT_PRECISION == 1) ? 3 : WEIGHT_WIDTH;
+    
+    // Memory entry: {sign, code}, prefixed with the destination id in CSR mode
+    localparam ENTRY_WIDTH = CODE_WIDTH + 1 + (SPARSE ? NEURON_ID_WIDTH : 0);
+    
+    // Fan-out pipeline: ISSUE (one memory row of READ_LANES weights per
+    // cycle) -> FETCH (memory latency) -> output register. The whole pipeline
+    // advances whenever the output register is free or being drained, so a
+    // stalled consumer holds every stage, including the memory read data.
+    //
+    // Dense rows only visit weight rows holding a nonzero weight
+    // (row_nonzero); CSR rows only hold real connections, and must list each
+    // destination once so the lanes of a beat stay distinct. Fan-out time per
+    // spike is therefore about connections / READ_LANES.
+    localparam NUM_GROUPS = NUM_NEURONS / READ_LANES;   // Dense: memory rows per axon
+    
+    // Fan-out in progress
+    reg                         active;
+    reg [AXON_ID_WIDTH-1:0]     current_axon;
+    reg [EDGE_ADDR_WIDTH:0]     slot_counter;   // CSR: next edge to fetch
+    reg [EDGE_ADDR_WIDTH:0]     slot_end;
+    reg [NUM_GROUPS-1:0]        remaining;      // Dense: nonzero memory rows still to fetch
+    
+    // Spikes queued behind the active fan-out; entry 0 starts next. Only
+    // paging looks further ahead than one spike.
+    localparam LOOKAHEAD = PAGED ? PREFETCH_DEPTH : 1;
+    localparam QUEUE_COUNT_WIDTH = $clog2(LOOKAHEAD + 1);
+    
+    reg [AXON_ID_WIDTH-1:0]     queue_axon [0:LOOKAHEAD-1];
+    reg [LOOKAHEAD-1:0]         queue_valid;    // Filled from entry 0 up
+    
+    wire                        spike_pending = queue_valid[0];
+    wire [AXON_ID_WIDTH-1:0]    pending_axon  = queue_axon[0];
+    
+    // FETCH stage
+    reg                         fetch_valid;
+    reg [NEURON_ID_WIDTH-1:0]   fetch_neuron;   // Dense destination of lane 0
+    reg [READ_LANES-1:0]        fetch_lanes;    // Lanes inside the row's slot range
+    reg [SCALE_WIDTH-1:0]       fetch_scale;
+    
+    // CSR row pointers: edges of axon a are row_ptr[a] .. row_ptr[a+1]-1
+    reg [EDGE_ADDR_WIDTH:0] row_ptr [0:NUM_AXONS];
+    
+    // Weight paging: the memory holds NUM_PAGES axon rows while the full
+    // matrix stays in DDR. The queued spikes are the lookahead: the first
+    // one whose row is not resident has it requested into another page
+    // while the active spike fans out of its own, so up to PREFETCH_DEPTH
+    // row fetches overlap fan-out. Pages are replaced round-robin, skipping
+    // the active page and the pages of queued spikes.
+    //
+    // In DDR a row is packed PAGE_WORD_CODES entries to a 32-bit word (3
+    // 9-bit, 8 4-bit or 16 ternary entries), rounded up to whole words.
+    // Each word is unpacked into the memory one weight per cycle.
+    localparam PAGE_ID_WIDTH = (NUM_PAGES > 1) ? $clog2(NUM_PAGES) : 1;
+    localparam NZ_ROWS = PAGED ? NUM_PAGES : NUM_AXONS;
+    localparam PAGE_ENTRY_WIDTH = CODE_WIDTH + 1;
+    localparam PAGE_WORD_CODES = 32 / PAGE_ENTRY_WIDTH;
+    localparam FILL_SLOT_WIDTH = $clog2(PAGE_WORD_CODES);
+    
+    reg [AXON_ID_WIDTH-1:0]     page_axon [0:NUM_PAGES-1];
+    reg [NUM_PAGES-1:0]         page_mapped;    // Page assigned to page_axon
+    reg [NUM_PAGES-1:0]         page_ready;     // ... and its row fully loaded
+    reg [PAGE_ID_WIDTH-1:0]     victim;         // Next page to replace
+    reg [PAGE_ID_WIDTH-1:0]     current_page;
+    reg                         fill_active;    // Request outstanding or row arriving
+    reg [PAGE_ID_WIDTH-1:0]     fill_page;
+    reg [NEURON_ID_WIDTH:0]     fill_count;
+    reg [31:0]                  fill_word;      // DDR word being unpacked
+    reg                         fill_word_valid;
+    reg [FILL_SLOT_WIDTH-1:0]   fill_slot;      // Its next entry
+    
+    // Dense nonzero map: bit n of row a is set when weight (a, n) is nonzero.
+    // Rows are indexed by page when paged. Like the weight memory it
+    // survives a soft reset.
+    reg [NUM_NEURONS-1:0] row_nonzero [0:NZ_ROWS-1];
     
-    reg [1:0] state;
-    reg [NEURON_ID_WIDTH-1:0] neuron_counter;
-    reg [AXON_ID_WIDTH-1:0] current_axon;
-    reg spike_pending;
+    integer a;
+    initial begin
+        for (a = 0; a < NZ_ROWS; a = a + 1) begin
+            row_nonzero[a] = 0;
+        end
+    end
     
     // Weight memory interface
-    wire [WEIGHT_WIDTH:0] weight_out;
+    wire [READ_LANES*ENTRY_WIDTH-1:0] row_out;
     wire weight_valid;
     
+    // Per-axon scale table
+    reg [SCALE_WIDTH-1:0] axon_scale [0:NUM_AXONS-1];
+    
+    // Per-lane decode: destination, sign, and dequantized magnitude
+    // saturated to WEIGHT_WIDTH
+    wire [READ_LANES-1:0]                 lane_nonzero;
+    wire [READ_LANES-1:0]                 lane_sign;
+    wire [READ_LANES*NEURON_ID_WIDTH-1:0] lane_dest;
+    wire [READ_LANES*WEIGHT_WIDTH-1:0]    lane_magnitude;
+    
+    genvar g;
+    generate
+        for (g = 0; g < READ_LANES; g = g + 1) begin : lane_decode
+            wire [ENTRY_WIDTH-1:0] entry_out = row_out[g*ENTRY_WIDTH +: ENTRY_WIDTH];
+            wire [CODE_WIDTH:0] weight_out = entry_out[CODE_WIDTH:0];
+            wire [CODE_WIDTH+(1<<SCALE_WIDTH)-1:0] scaled_weight;
+            
+            assign lane_nonzero[g] = |weight_out[CODE_WIDTH-1:0];
+            assign lane_sign[g] = weight_out[CODE_WIDTH];
+            
+            if (SPARSE) begin : csr_dest
+                assign lane_dest[g*NEURON_ID_WIDTH +: NEURON_ID_WIDTH] = entry_out[ENTRY_WIDTH-1:CODE_WIDTH+1];
+            end else begin : dense_dest
+                assign lane_dest[g*NEURON_ID_WIDTH +: NEURON_ID_WIDTH] = fetch_neuron + g;
+            end
+            
+            if (WEIGHT_PRECISION == 0) begin : full_precision
+                assign scaled_weight = weight_out[CODE_WIDTH-1:0];
+                assign lane_magnitude[g*WEIGHT_WIDTH +: WEIGHT_WIDTH] = weight_out[CODE_WIDTH-1:0];
+            end else begin : low_precision
+                assign scaled_weight = weight_out[CODE_WIDTH-1:0] << fetch_scale;
+                assign lane_magnitude[g*WEIGHT_WIDTH +: WEIGHT_WIDTH] =
+                    (|(scaled_weight >> WEIGHT_WIDTH)) ? {WEIGHT_WIDTH{1'b1}} : scaled_weight[WEIGHT_WIDTH-1:0];
+            end
+        end
+    endgenerate
+    
+    //-------------------------------------------------------------------------
+    // Fan-out control
+    //-------------------------------------------------------------------------
+    wire out_free = !spike_out_valid || spike_out_ready;
+    wire issue = enable && active && out_free;
+    
+    // Lowest dense memory row left that holds a nonzero weight
+    reg [NEURON_ID_WIDTH-1:0] next_neuron;      // First neuron of that row
+    integer n;
+    always @(*) begin
+        next_neuron = 0;
+        for (n = NUM_GROUPS - 1; n >= 0; n = n - 1) begin
+            if (remaining[n]) next_neuron = n * READ_LANES;
+        end
+    end
+    
+    wire [NUM_GROUPS-1:0] remaining_after = remaining & (remaining - 1'b1);   // Lowest bit cleared
+    
+    // CSR: memory row holding slot_counter; a fan-out may begin and end mid-row
+    wire [EDGE_ADDR_WIDTH:0] slot_row  = (slot_counter / READ_LANES) * READ_LANES;
+    wire [EDGE_ADDR_WIDTH:0] slot_next = slot_row + READ_LANES;
+    
+    reg [READ_LANES-1:0] issue_lanes;
+    integer k;
+    always @(*) begin
+        for (k = 0; k < READ_LANES; k = k + 1) begin
+            issue_lanes[k] = !SPARSE || ((slot_row + k >= slot_counter) && (slot_row + k < slot_end));
+        end
+    end
+    
+    wire issue_last = SPARSE ? (slot_next >= slot_end) : (remaining_after == 0);
+    wire finishing = issue && issue_last;
+    
+    // Page holding the next spike's row
+    reg [PAGE_ID_WIDTH-1:0] pending_page;
+    reg pending_resident;
+    integer pg;
+    always @(*) begin
+        pending_page = 0;
+        pending_resident = 1'b0;
+        for (pg = 0; pg < NUM_PAGES; pg = pg + 1) begin
+            if (page_mapped[pg] && page_axon[pg] == pending_axon) begin
+                pending_page = pg;
+                pending_resident = page_ready[pg];
+            end
+        end
+    end
+    
+    wire pending_hit = !PAGED || pending_resident;
+    
+    // Row to prefetch: the first queued spike whose axon has no page yet.
+    // Pages the active or a queued spike still needs are held.
+    reg [NUM_PAGES-1:0]     page_held;
+    reg [LOOKAHEAD-1:0]     queue_mapped;
+    reg                     prefetch_needed;
+    reg [AXON_ID_WIDTH-1:0] prefetch_axon;
+    integer hp, hq;
+    always @(*) begin
+        page_held = 0;
+        queue_mapped = 0;
+        for (hp = 0; hp < NUM_PAGES; hp = hp + 1) begin
+            if (active && current_page == hp)
+                page_held[hp] = 1'b1;
+            for (hq = 0; hq < LOOKAHEAD; hq = hq + 1) begin
+                if (queue_valid[hq] && page_mapped[hp] && page_axon[hp] == queue_axon[hq]) begin
+                    page_held[hp] = 1'b1;
+                    queue_mapped[hq] = 1'b1;
+                end
+            end
+        end
+        prefetch_needed = 1'b0;
+        prefetch_axon = 0;
+        for (hq = LOOKAHEAD - 1; hq >= 0; hq = hq - 1) begin
+            if (queue_valid[hq] && !queue_mapped[hq]) begin
+                prefetch_needed = 1'b1;
+                prefetch_axon = queue_axon[hq];
+            end
+        end
+    end
+    
+    // Page to replace: the first one not held, round-robin from victim
+    reg [PAGE_ID_WIDTH-1:0] alloc_page;
+    reg                     alloc_free;
+    integer vp;
+    always @(*) begin
+        alloc_page = victim;
+        alloc_free = 1'b0;
+        for (vp = NUM_PAGES - 1; vp >= 0; vp = vp - 1) begin
+            if (!page_held[(victim + vp) % NUM_PAGES]) begin
+                alloc_page = (victim + vp) % NUM_PAGES;
+                alloc_free = 1'b1;
+            end
+        end
+    end
+    
+    // Row of the next spike, grouped into dense memory rows
+    wire [EDGE_ADDR_WIDTH:0] pending_begin = row_ptr[pending_axon];
+    wire [EDGE_ADDR_WIDTH:0] pending_end   = row_ptr[pending_axon + 1];
+    wire [NUM_NEURONS-1:0]   pending_row   = row_nonzero[PAGED ? pending_page : pending_axon];
+    
+    reg [NUM_GROUPS-1:0] pending_groups;
+    integer p;
+    always @(*) begin
+        for (p = 0; p < NUM_GROUPS; p = p + 1) begin
+            pending_groups[p] = |pending_row[p*READ_LANES +: READ_LANES];
+        end
+    end
+    
+    wire pending_empty = SPARSE ? (pending_begin == pending_end) : (pending_groups == 0);
+    
+    // The next spike starts as soon as the active one issues its last
+    // read and its row is resident
+    wire start = enable && spike_pending && pending_hit && (!active || finishing);
+    assign spike_in_ready = !queue_valid[LOOKAHEAD-1] || start;
+    
+    // Queue slot of an accepted spike
+    reg [QUEUE_COUNT_WIDTH-1:0] queue_count;
+    integer qc;
+    always @(*) begin
+        queue_count = 0;
+        for (qc = 0; qc < LOOKAHEAD; qc = qc + 1) begin
+            queue_count = queue_count + queue_valid[qc];
+        end
+    end
+    wire [QUEUE_COUNT_WIDTH-1:0] push_slot = queue_count - start;
+    
+    // One row request in flight
+    wire page_request = PAGED && enable && prefetch_needed && alloc_free && !fill_active;
+    
+    // Row fill: one entry of the held DDR word per cycle
+    wire page_fill = fill_active && fill_word_valid;
+    wire [PAGE_ENTRY_WIDTH-1:0] fill_entry = fill_word[fill_slot*PAGE_ENTRY_WIDTH +: PAGE_ENTRY_WIDTH];
+    wire fill_last = (fill_count == NUM_NEURONS - 1);
+    wire fill_word_done = (fill_slot == PAGE_WORD_CODES - 1) || fill_last;
+    
+    // Stray words (a fill cut short by a soft reset) are drained, not written
+    assign page_fill_ready = !fill_active || !fill_word_valid || fill_word_done;
+    assign page_miss = page_request;
+    assign page_stall = PAGED && enable && spike_pending && !active && !pending_resident;
+    
+    integer q;
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            active <= 1'b0;
+            current_axon <= 0;
+            current_page <= 0;
+            slot_counter <= 0;
+            slot_end <= 0;
+            remaining <= 0;
+            queue_valid <= 0;
+            for (q = 0; q < LOOKAHEAD; q = q + 1) begin
+                queue_axon[q] <= 0;
+            end
+        end else begin
+            // Input spike capture behind the queued spikes
+            if (start) begin
+                for (q = 0; q < LOOKAHEAD - 1; q = q + 1) begin
+                    queue_valid[q] <= queue_valid[q + 1];
+                    queue_axon[q] <= queue_axon[q + 1];
+                end
+                queue_valid[LOOKAHEAD-1] <= 1'b0;
+            end
+            if (spike_in_valid && spike_in_ready) begin
+                queue_valid[push_slot] <= 1'b1;
+                queue_axon[push_slot] <= spike_in_axon_id;
+            end
+            
+            if (issue) begin
+                slot_counter <= slot_next;
+                remaining <= remaining_after;
+            end
+            
+            if (start) begin
+                // Axons without synapses are dropped without a fan-out
+                active <= !pending_empty;
+                current_axon <= pending_axon;
+                slot_counter <= pending_begin;
+                slot_end <= pending_end;
+                remaining <= pending_groups;
+                current_page <= pending_page;
+            end else if (finishing) begin
+                active <= 1'b0;
+            end
+        end
+    end
+    
+    // Page table and row fill
+    integer pt;
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            page_mapped <= 0;
+            page_ready <= 0;
+            victim <= 0;
+            fill_active <= 1'b0;
+            fill_page <= 0;
+            fill_count <= 0;
+            fill_word <= 32'd0;
+            fill_word_valid <= 1'b0;
+            fill_slot <= 0;
+            page_req_valid <= 1'b0;
+            page_req_axon <= 0;
+            for (pt = 0; pt < NUM_PAGES; pt = pt + 1) begin
+                page_axon[pt] <= 0;
+            end
+        end else begin
+            if (page_request) begin
+                page_req_valid <= 1'b1;
+                page_req_axon <= prefetch_axon;
+                page_axon[alloc_page] <= prefetch_axon;
+                page_mapped[alloc_page] <= 1'b1;
+                page_ready[alloc_page] <= 1'b0;
+                victim <= alloc_page + 1'b1;
+                fill_active <= 1'b1;
+                fill_page <= alloc_page;
+                fill_count <= 0;
+            end else if (page_req_valid && page_req_ready) begin
+                page_req_valid <= 1'b0;
+            end
+            
+            if (page_fill) begin
+                fill_count <= fill_count + 1'b1;
+                fill_slot <= fill_slot + 1'b1;
+                if (fill_last) begin
+                    fill_active <= 1'b0;
+                    page_ready[fill_page] <= 1'b1;
+                end
+            end
+            
+            // Take the next word as the held one runs out; entries past the
+            // row's end in its last word are padding
+            if (fill_active && page_fill_valid && page_fill_ready && !(page_fill && fill_last)) begin
+                fill_word <= page_fill_data;
+                fill_word_valid <= 1'b1;
+                fill_slot <= 0;
+            end else if (page_fill && fill_word_done) begin
+                fill_word_valid <= 1'b0;
+            end
+        end
+    end
+    
     // Address calculation for weight memory
-    wire [$clog2(NUM_AXONS * NUM_NEURONS)-1:0] read_addr;
-    wire [$clog2(NUM_AXONS * NUM_NEURONS)-1:0] write_addr;
+    wire [EDGE_ADDR_WIDTH-1:0] read_addr;
+    wire [EDGE_ADDR_WIDTH-1:0] write_addr;
+    wire [ENTRY_WIDTH-1:0] write_entry;
+    wire write_en;
     
-    assign read_addr = (current_axon * NUM_NEURONS) + neuron_counter;
-    assign write_addr = (weight_addr_axon * NUM_NEURONS) + weight_addr_neuron;
+    generate
+        if (SPARSE) begin : csr_store
+            assign read_addr = slot_counter[EDGE_ADDR_WIDTH-1:0];
+            assign write_addr = edge_addr;
+            assign write_entry = {edge_data[NEURON_ID_WIDTH+WEIGHT_WIDTH:WEIGHT_WIDTH+1],
+                                  edge_data[WEIGHT_WIDTH], edge_data[CODE_WIDTH-1:0]};
+            assign write_en = edge_we;
+        end else begin : dense_store
+            assign read_addr = ((PAGED ? current_page : current_axon) * NUM_NEURONS) + next_neuron;
+            assign write_addr = PAGED ? (fill_page * NUM_NEURONS) + fill_count :
+                                        (weight_addr_axon * NUM_NEURONS) + weight_addr_neuron;
+            assign write_entry = PAGED ? fill_entry :
+                                         {weight_data[WEIGHT_WIDTH], weight_data[CODE_WIDTH-1:0]};
+            assign write_en = PAGED ? page_fill : weight_we;
+        end
+    endgenerate
     
-    // Instantiate weight memory
+    // Instantiate weight memory. Narrow codes shrink each entry, so a
+    // NUM_EDGES scaled by 2x/4x (more pages, axons or edges) fits the BRAM
+    // an 8-bit store of the original size needs. With READ_LANES > 1 each
+    // lane is padded to a byte-write column, which takes that gain back.
     weight_memory #(
-        .NUM_WEIGHTS(NUM_AXONS * NUM_NEURONS),
-        .WEIGHT_WIDTH(WEIGHT_WIDTH + 1),  // +1 for sign bit
+        .NUM_WEIGHTS(NUM_EDGES),
+        .WEIGHT_WIDTH(ENTRY_WIDTH),       // Code + sign (+ destination in CSR mode)
+        .READ_LANES(READ_LANES),
         .USE_BRAM(USE_BRAM)
     ) weight_mem_inst (
         .clk(clk),
         .rst_n(rst_n),
         
-        // Read port
-        .read_en(state == FETCH),
+        // Read port (read_data holds while read_en is low)
+        .read_en(issue),
         .read_addr(read_addr),
-        .read_data(weight_out),
+        .read_data(row_out),
         
         // Write port
-        .write_en(weight_we),
+        .write_en(write_en),
         .write_addr(write_addr),
-        .write_data(weight_data),
+        .write_data(write_entry),
         
         .read_valid(weight_valid)
     );
     
-    // Input spike capture
+    // Nonzero map follows dense weight writes (row fills when paged)
+    always @(posedge clk) begin
+        if (!SPARSE && PAGED && page_fill) begin
+            row_nonzero[fill_page][fill_count] <= |fill_entry[CODE_WIDTH-1:0];
+        end else if (!SPARSE && !PAGED && weight_we) begin
+            row_nonzero[weight_addr_axon][weight_addr_neuron] <= |weight_data[CODE_WIDTH-1:0];
+        end
+    end
+    
+    // Row pointer write (all rows empty after reset)
+    integer r;
     always @(posedge clk) begin
         if (!rst_n) begin
-            spike_pending <= 1'b0;
-            current_axon <= 0;
-        end else if (spike_in_valid && state == IDLE) begin
-            spike_pending <= 1'b1;
-            current_axon <= spike_in_axon_id;
-        end else if (state == DELIVER && neuron_counter == NUM_NEURONS - 1) begin
-            spike_pending <= 1'b0;
+            for (r = 0; r <= NUM_AXONS; r = r + 1) begin
+                row_ptr[r] <= 0;
+            end
+        end else if (row_ptr_we && row_ptr_addr <= NUM_AXONS) begin
+            row_ptr[row_ptr_addr] <= row_ptr_data;
         end
     end
     
-    // State machine
+    // Scale table write
+    integer s;
     always @(posedge clk) begin
         if (!rst_n) begin
-            state <= IDLE;
-            neuron_counter <= 0;
-        end else if (enable) begin
-            case (state)
-                IDLE: begin
-                    if (spike_pending) begin
-                        state <= FETCH;
-                        neuron_counter <= 0;
-                    end
-                end
-                
-                FETCH: begin
-                    state <= DELIVER;
-                end
-                
-                DELIVER: begin
-                    if (neuron_counter == NUM_NEURONS - 1) begin
-                        state <= IDLE;
-                        neuron_counter <= 0;
-                    end else begin
-                        neuron_counter <= neuron_counter + 1'b1;
-                        state <= FETCH;
-                    end
-                end
-                
-                default: state <= IDLE;
-            endcase
+            for (s = 0; s < NUM_AXONS; s = s + 1) begin
+                axon_scale[s] <= 0;
+            end
+        end else if (scale_we) begin
+            axon_scale[scale_addr_axon] <= scale_data;
+        end
+    end
+    
+    // FETCH stage
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            fetch_valid <= 1'b0;
+            fetch_neuron <= 0;
+            fetch_lanes <= 0;
+            fetch_scale <= 0;
+        end else if (out_free) begin
+            fetch_valid <= issue;
+            fetch_neuron <= next_neuron;
+            fetch_lanes <= issue_lanes;
+            fetch_scale <= axon_scale[current_axon];
         end
     end
     
     // Output generation
     always @(posedge clk) begin
         if (!rst_n) begin
-            spike_out_valid <= 1'b0;
+            spike_out_valid <= 0;
             spike_out_neuron_id <= 0;
             spike_out_weight <= 0;
-            spike_out_exc_inh <= 1'b1;
-        end else begin
-            spike_out_valid <= 1'b0;
-            
-            if (state == DELIVER && weight_valid) begin
-                // Only output if weight is non-zero
-                if (|weight_out[WEIGHT_WIDTH-1:0]) begin
-                    spike_out_valid <= 1'b1;
-                    spike_out_neuron_id <= neuron_counter;
-                    spike_out_weight <= weight_out[WEIGHT_WIDTH-1:0];
-                    spike_out_exc_inh <= weight_out[WEIGHT_WIDTH];  // Sign bit
-                end
-            end
+            spike_out_exc_inh <= {READ_LANES{1'b1}};
+        end else if (out_free) begin
+            // Only output lanes with a non-zero weight (CSR entries may still hold zero codes)
+            spike_out_valid <= {READ_LANES{fetch_valid}} & fetch_lanes & lane_nonzero;
+            spike_out_neuron_id <= lane_dest;
+            spike_out_weight <= lane_magnitude;
+            spike_out_exc_inh <= lane_sign;
         end
     end
 
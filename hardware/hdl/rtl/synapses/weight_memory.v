@@ -11,18 +11,19 @@
 
 module weight_memory #(
     parameter NUM_WEIGHTS   = 4096,    // Total number of weights
-    parameter WEIGHT_WIDTH  = 9,       // Bits per weight (8 + sign)
+    parameter WEIGHT_WIDTH  = 9,       // Bits per weight (8 + sign, 4 or 2 in low-precision modes)
     parameter ADDR_WIDTH    = $clog2(NUM_WEIGHTS),
+    parameter READ_LANES    = 1,       // Weights returned per read (power of two)
     parameter USE_BRAM      = 1,       // 1: BRAM, 0: Distributed RAM
-    parameter INIT_FILE     = ""       // Memory initialization file
+    parameter INIT_FILE     = ""       // Memory initialization file (one stored row per line)
 )(
     input  wire                     clk,
     input  wire                     rst_n,
     
-    // Read port
+    // Read port: the READ_LANES-aligned row holding read_addr, lane 0 in the low bits
     input  wire                     read_en,
     input  wire [ADDR_WIDTH-1:0]    read_addr,
-    output reg  [WEIGHT_WIDTH-1:0]  read_data,
+    output reg  [READ_LANES*WEIGHT_WIDTH-1:0] read_data,
     output reg                      read_valid,
     
     // Write port
@@ -34,12 +35,45 @@ module weight_memory #(
     output wire                     mem_busy
 );
 
+    // Rows of READ_LANES weights side by side, written one weight at a
+    // time. BRAM byte-write enables cover 8- or 9-bit columns only, so with
+    // several lanes each lane is padded to whole columns (9 bits for 9- and
+    // 18-bit entries, 8 otherwise: 2/4-bit codes take one byte, 15-bit CSR
+    // entries two); any other split would infer a read-modify-write or
+    // LUTRAM. 9-bit weights need no padding, and four lanes fill the 36-bit
+    // port of a RAMB18 (eight the 72-bit port of a RAMB36) as the narrow
+    // store would. Padded narrow codes spend the extra bits, so wide reads
+    // of 2/4-bit codes lose the density a single lane gets from them.
+    localparam NUM_ROWS   = (NUM_WEIGHTS + READ_LANES - 1) / READ_LANES;
+    localparam COL_WIDTH  = (READ_LANES == 1) ? WEIGHT_WIDTH :
+                            (WEIGHT_WIDTH % 9 == 0) ? 9 : 8;
+    localparam LANE_COLS  = (WEIGHT_WIDTH + COL_WIDTH - 1) / COL_WIDTH;
+    localparam LANE_WIDTH = LANE_COLS * COL_WIDTH;
+    localparam NUM_COLS   = READ_LANES * LANE_COLS;
+    localparam ROW_WIDTH  = READ_LANES * LANE_WIDTH;
+    
+    wire [ADDR_WIDTH-1:0] read_row   = read_addr / READ_LANES;
+    wire [ADDR_WIDTH-1:0] write_row  = write_addr / READ_LANES;
+    wire [ADDR_WIDTH-1:0] write_lane = write_addr % READ_LANES;
+    wire [LANE_WIDTH-1:0] write_word = write_data;
+    
+    // Drop the lane padding of a stored row
+    function [READ_LANES*WEIGHT_WIDTH-1:0] unpack_row(input [ROW_WIDTH-1:0] row);
+        integer l;
+        begin
+            for (l = 0; l < READ_LANES; l = l + 1)
+                unpack_row[l*WEIGHT_WIDTH +: WEIGHT_WIDTH] = row[l*LANE_WIDTH +: WEIGHT_WIDTH];
+        end
+    endfunction
+    
+    integer col;
+    
     // Memory array
     generate
         if (USE_BRAM) begin : bram_storage
             // Use Xilinx Block RAM primitive for PYNQ-Z2
             (* ram_style = "block" *)
-            reg [WEIGHT_WIDTH-1:0] bram_array [0:NUM_WEIGHTS-1];
+            reg [ROW_WIDTH-1:0] bram_array [0:NUM_ROWS-1];
             
             // Initialize memory if file provided
             initial begin
@@ -47,7 +81,7 @@ module weight_memory #(
                     $readmemh(INIT_FILE, bram_array);
                 end else begin
                     integer i;
-                    for (i = 0; i < NUM_WEIGHTS; i = i + 1) begin
+                    for (i = 0; i < NUM_ROWS; i = i + 1) begin
                         bram_array[i] = 0;
                     end
                 end
@@ -60,7 +94,7 @@ module weight_memory #(
                     read_valid <= 1'b0;
                 end else begin
                     if (read_en) begin
-                        read_data <= bram_array[read_addr];
+                        read_data <= unpack_row(bram_array[read_row]);
                         read_valid <= 1'b1;
                     end else begin
                         read_valid <= 1'b0;
@@ -68,17 +102,20 @@ module weight_memory #(
                 end
             end
             
-            // Write port
+            // Write port: one write enable per column of the addressed lane
             always @(posedge clk) begin
-                if (write_en) begin
-                    bram_array[write_addr] <= write_data;
+                for (col = 0; col < NUM_COLS; col = col + 1) begin
+                    if (write_en && write_lane == col / LANE_COLS) begin
+                        bram_array[write_row][col*COL_WIDTH +: COL_WIDTH] <=
+                            write_word[(col % LANE_COLS)*COL_WIDTH +: COL_WIDTH];
+                    end
                 end
             end
             
         end else begin : distributed_storage
             // Use distributed RAM for smaller arrays
             (* ram_style = "distributed" *)
-            reg [WEIGHT_WIDTH-1:0] dist_ram_array [0:NUM_WEIGHTS-1];
+            reg [ROW_WIDTH-1:0] dist_ram_array [0:NUM_ROWS-1];
             
             // Initialize memory
             initial begin
@@ -86,7 +123,7 @@ module weight_memory #(
                     $readmemh(INIT_FILE, dist_ram_array);
                 end else begin
                     integer i;
-                    for (i = 0; i < NUM_WEIGHTS; i = i + 1) begin
+                    for (i = 0; i < NUM_ROWS; i = i + 1) begin
                         dist_ram_array[i] = 0;
                     end
                 end
@@ -99,7 +136,7 @@ module weight_memory #(
                     read_valid <= 1'b0;
                 end else begin
                     if (read_en) begin
-                        read_data <= dist_ram_array[read_addr];
+                        read_data <= unpack_row(dist_ram_array[read_row]);
                         read_valid <= 1'b1;
                     end else begin
                         read_valid <= 1'b0;
@@ -107,10 +144,13 @@ module weight_memory #(
                 end
             end
             
-            // Write port
+            // Write port: one write enable per column of the addressed lane
             always @(posedge clk) begin
-                if (write_en) begin
-                    dist_ram_array[write_addr] <= write_data;
+                for (col = 0; col < NUM_COLS; col = col + 1) begin
+                    if (write_en && write_lane == col / LANE_COLS) begin
+                        dist_ram_array[write_row][col*COL_WIDTH +: COL_WIDTH] <=
+                            write_word[(col % LANE_COLS)*COL_WIDTH +: COL_WIDTH];
+                    end
                 end
             end
         end
@@ -22,10 +22,19 @@ module snn_accelerator_top #(
     parameter AXON_ID_WIDTH        = $clog2(NUM_AXONS),
     parameter DATA_WIDTH           = 16,
     parameter WEIGHT_WIDTH         = 8,
+    parameter WEIGHT_PRECISION     = 0,       // 0: 8-bit, 1: 4-bit, 2: ternary weights
+    parameter SPARSE_SYNAPSES      = 0,       // 1: CSR synapse store instead of dense matrix
+    parameter NUM_SYNAPSE_EDGES    = 4096,    // Synapse slots in CSR mode
+    parameter SYNAPSE_LANES        = 4,       // Synaptic events per clock, synapses to neurons
+    parameter WEIGHT_PAGING        = 0,       // 1: dense weights stay in DDR, rows paged into BRAM
+    parameter NUM_WEIGHT_PAGES     = 8,       // Paging BRAM budget, in rows of 8-bit weights
+    parameter WEIGHT_PREFETCH      = 4,       // Paging: queued spikes whose rows are fetched ahead (< pages)
     parameter LEAK_WIDTH           = 8,
     parameter THRESHOLD_WIDTH      = 16,
     parameter REFRAC_WIDTH         = 8,
-    parameter ROUTER_BUFFER_DEPTH  = 256
+    parameter ROUTER_BUFFER_DEPTH  = 256,
+    parameter ROUTER_BANKS         = 1,       // Parallel router banks (power of two)
+    parameter TILE_ID              = 0        // Position on the AER tile ring, 0 .. 15
 )(
     //-------------------------------------------------------------------------
     // Clock and Reset
@@ -81,6 +90,53 @@ module snn_accelerator_top #(
     input  wire                          m_axis_tready,
     output wire                          m_axis_tlast,
     
+    //-------------------------------------------------------------------------
+    // AXI4-Stream Slave Interface (Bulk Table Load from DMA)
+    //-------------------------------------------------------------------------
+    input  wire [31:0]                   s_axis_load_tdata,
+    input  wire                          s_axis_load_tvalid,
+    output wire                          s_axis_load_tready,
+    input  wire                          s_axis_load_tlast,
+    
+    //-------------------------------------------------------------------------
+    // AXI4-Stream Master Interface (State Snapshot to DMA)
+    //-------------------------------------------------------------------------
+    output wire [31:0]                   m_axis_state_tdata,
+    output wire                          m_axis_state_tvalid,
+    input  wire                          m_axis_state_tready,
+    output wire                          m_axis_state_tlast,
+    
+    //-------------------------------------------------------------------------
+    // AXI4-Stream Master Interface (Weight Page Commands to AXI DataMover)
+    //-------------------------------------------------------------------------
+    output wire [71:0]                   m_axis_page_cmd_tdata,
+    output wire                          m_axis_page_cmd_tvalid,
+    input  wire                          m_axis_page_cmd_tready,
+    
+    //-------------------------------------------------------------------------
+    // AXI4-Stream Slave Interface (Weight Page Data from AXI DataMover)
+    //-------------------------------------------------------------------------
+    input  wire [31:0]                   s_axis_page_tdata,
+    input  wire                          s_axis_page_tvalid,
+    output wire                          s_axis_page_tready,
+    input  wire                          s_axis_page_tlast,
+    
+    //-------------------------------------------------------------------------
+    // AXI4-Stream AER Tile Link (spikes from the previous tile on the ring)
+    //-------------------------------------------------------------------------
+    input  wire [31:0]                   s_axis_aer_tdata,
+    input  wire                          s_axis_aer_tvalid,
+    output wire                          s_axis_aer_tready,
+    input  wire                          s_axis_aer_tlast,
+    
+    //-------------------------------------------------------------------------
+    // AXI4-Stream AER Tile Link (spikes to the next tile on the ring)
+    //-------------------------------------------------------------------------
+    output wire [31:0]                   m_axis_aer_tdata,
+    output wire                          m_axis_aer_tvalid,
+    input  wire                          m_axis_aer_tready,
+    output wire                          m_axis_aer_tlast,
+    
     //-------------------------------------------------------------------------
     // Interrupt to PS
     //-------------------------------------------------------------------------
@@ -128,14 +184,20 @@ module snn_accelerator_top #(
     wire [WEIGHT_WIDTH-1:0]     input_spike_weight;
     wire                        input_spike_ready;
     
+    // Synapse input: host spikes merged with spikes from other tiles
+    wire                        synapse_in_valid;
+    wire [AXON_ID_WIDTH-1:0]    synapse_in_axon;
+    wire                        synapse_in_ready;
+    
     wire                        neuron_spike_valid;
     wire [NEURON_ID_WIDTH-1:0]  neuron_spike_id;
     wire                        neuron_spike_ready;
+    wire                        router_in_ready;
     
-    wire                        routed_spike_valid;
-    wire [NEURON_ID_WIDTH-1:0]  routed_spike_dest_id;
-    wire [WEIGHT_WIDTH-1:0]     routed_spike_weight;
-    wire                        routed_spike_exc_inh;
+    wire [SYNAPSE_LANES-1:0]                 routed_spike_valid;
+    wire [SYNAPSE_LANES*NEURON_ID_WIDTH-1:0] routed_spike_dest_id;
+    wire [SYNAPSE_LANES*WEIGHT_WIDTH-1:0]    routed_spike_weight;
+    wire [SYNAPSE_LANES-1:0]                 routed_spike_exc_inh;
     wire                        routed_spike_ready;
     
     wire                        output_spike_valid;
@@ -149,6 +211,59 @@ module snn_accelerator_top #(
     wire                        fifo_overflow;
     wire                        array_busy;
     
+    // Router overflow policy and overload statistics
+    wire [31:0]                 router_policy;
+    wire [31:0]                 router_drop_newest;
+    wire [31:0]                 router_drop_oldest;
+    wire [31:0]                 router_drop_sampled;
+    wire [31:0]                 router_stalls;
+    wire [15:0]                 router_peak;
+    
+    // Bulk table load (targets match the AXI-Lite write regions)
+    localparam LOAD_WEIGHTS     = 8'h01;  // Dense weights, index axon * NUM_NEURONS + neuron
+    localparam LOAD_NEURONS     = 8'h02;  // Neuron state words (snapshot restore)
+    localparam LOAD_ROUTER      = 8'h03;  // Router connection words, bank in addr[23:16]
+    localparam LOAD_SCALES      = 8'h04;  // Per-axon scale shifts
+    localparam LOAD_EDGES       = 8'h05;  // CSR synapse entries
+    localparam LOAD_ROW_PTR     = 8'h06;  // CSR row pointers
+    localparam LOAD_FANOUT      = 8'h07;  // Router connection counts
+    localparam LOAD_CONN_BASE   = 8'h08;  // Router row bases into the packed connection array
+    localparam LOAD_AER_EXPORT  = 8'h09;  // AER export entries (remote tiles per neuron)
+    
+    wire                        load_wr_en;
+    wire [7:0]                  load_wr_target;
+    wire [23:0]                 load_wr_addr;
+    wire [31:0]                 load_wr_data;
+    wire                        load_busy;
+    wire                        load_done;
+    wire                        load_error;
+    wire [31:0]                 load_words;
+    
+    // Neuron state snapshot
+    wire                        snapshot_start;
+    wire [NEURON_ID_WIDTH-1:0]  snapshot_rd_addr;
+    wire [31:0]                 snapshot_rd_data;
+    wire                        snapshot_busy;
+    wire                        snapshot_done;
+    
+    // Weight paging
+    wire [31:0]                 page_base;
+    wire                        page_req_valid;
+    wire [AXON_ID_WIDTH-1:0]    page_req_axon;
+    wire                        page_miss;
+    wire                        page_stall;
+    reg  [31:0]                 page_miss_count;
+    reg  [31:0]                 page_stall_count;
+    
+    // AER tile link
+    wire                        aer_import_valid;
+    wire [AXON_ID_WIDTH-1:0]    aer_import_axon;
+    wire                        aer_local_ready;
+    wire [31:0]                 aer_exported_count;
+    wire [31:0]                 aer_imported_count;
+    wire [31:0]                 aer_returned_count;
+    wire                        aer_busy;
+    
     //-------------------------------------------------------------------------
     // Clock and Reset
     //-------------------------------------------------------------------------
@@ -210,6 +325,18 @@ module snn_accelerator_top #(
         .refractory_period(refractory_period),
         .status_reg(status_reg),
         .spike_count(spike_count),
+        .page_base(page_base),
+        .page_misses(page_miss_count),
+        .page_stalls(page_stall_count),
+        .aer_exported(aer_exported_count),
+        .aer_imported(aer_imported_count),
+        .aer_returned(aer_returned_count),
+        .router_policy(router_policy),
+        .router_drop_newest(router_drop_newest),
+        .router_drop_oldest(router_drop_oldest),
+        .router_drop_sampled(router_drop_sampled),
+        .router_stalls(router_stalls),
+        .router_peak(router_peak),
         
         // Spike interface
         .spike_in_valid(input_spike_valid),
@@ -226,38 +353,181 @@ module snn_accelerator_top #(
     assign snn_reset = ctrl_reg[1];
     assign clear_counters = ctrl_reg[2];
     
+    // Rising edge of ctrl_reg[4] starts a neuron state snapshot
+    reg snapshot_req_d;
+    always @(posedge sys_clk) begin
+        if (!sys_rst_n)
+            snapshot_req_d <= 1'b0;
+        else
+            snapshot_req_d <= ctrl_reg[4];
+    end
+    assign snapshot_start = ctrl_reg[4] & ~snapshot_req_d;
+    
+    //-------------------------------------------------------------------------
+    // Bulk Table Loader
+    //-------------------------------------------------------------------------
+    // DMA packets fill connection and weight tables one word per cycle. While
+    // a packet is being written it owns the table write ports; AXI-Lite writes
+    // to the same tables are ignored for those cycles.
+    stream_loader #(
+        .DATA_WIDTH(32),
+        .ADDR_WIDTH(24)
+    ) stream_loader_inst (
+        .clk(sys_clk),
+        .rst_n(sys_rst_n),
+        
+        .s_axis_tdata(s_axis_load_tdata),
+        .s_axis_tvalid(s_axis_load_tvalid),
+        .s_axis_tready(s_axis_load_tready),
+        .s_axis_tlast(s_axis_load_tlast),
+        
+        .wr_en(load_wr_en),
+        .wr_target(load_wr_target),
+        .wr_addr(load_wr_addr),
+        .wr_data(load_wr_data),
+        
+        .load_busy(load_busy),
+        .load_done(load_done),
+        .load_error(load_error),
+        .load_words(load_words)
+    );
+    
+    wire load_weight  = load_wr_en && (load_wr_target == LOAD_WEIGHTS);
+    wire load_neuron  = load_wr_en && (load_wr_target == LOAD_NEURONS);
+    wire load_scale   = load_wr_en && (load_wr_target == LOAD_SCALES);
+    wire load_edge    = load_wr_en && (load_wr_target == LOAD_EDGES);
+    wire load_row_ptr = load_wr_en && (load_wr_target == LOAD_ROW_PTR);
+    wire load_router  = load_wr_en && ((load_wr_target == LOAD_ROUTER) ||
+                                       (load_wr_target == LOAD_FANOUT) ||
+                                       (load_wr_target == LOAD_CONN_BASE));
+    wire load_aer     = load_wr_en && (load_wr_target == LOAD_AER_EXPORT);
+    
     //-------------------------------------------------------------------------
     // Synapse Array
     //-------------------------------------------------------------------------
+    // Spikes from other tiles go ahead of host spikes
+    assign synapse_in_valid  = aer_import_valid || input_spike_valid;
+    assign synapse_in_axon   = aer_import_valid ? aer_import_axon
+                                                : input_spike_neuron_id[AXON_ID_WIDTH-1:0];
+    assign input_spike_ready = synapse_in_ready && !aer_import_valid;
+    
+    // Resident pages are sized from the bits weight_memory actually stores per
+    // paged entry (code + sign). A single lane stores entries unpadded, so
+    // 4-bit and ternary codes fit 2x and 4x the rows of 9-bit entries in the
+    // same BRAM; with several lanes each lane is padded to an 8- or 9-bit
+    // byte column, and narrow codes keep no more rows resident than 8-bit ones
+    localparam PAGE_ENTRY_WIDTH = (WEIGHT_PRECISION == 2) ? 2 : (WEIGHT_PRECISION == 1) ? 4 :
+                                  WEIGHT_WIDTH + 1;
+    localparam PAGE_COL_WIDTH   = (SYNAPSE_LANES == 1) ? PAGE_ENTRY_WIDTH :
+                                  (PAGE_ENTRY_WIDTH % 9 == 0) ? 9 : 8;
+    localparam PAGE_LANE_WIDTH  = ((PAGE_ENTRY_WIDTH + PAGE_COL_WIDTH - 1) / PAGE_COL_WIDTH) *
+                                  PAGE_COL_WIDTH;
+    localparam CODES_PER_ENTRY  = (WEIGHT_WIDTH + 1) / PAGE_LANE_WIDTH;
+    localparam RESIDENT_PAGES   = NUM_WEIGHT_PAGES * CODES_PER_ENTRY;
+    localparam WEIGHTS_PAGED   = WEIGHT_PAGING && !SPARSE_SYNAPSES;
+    
+    // Paged dense weights are written to DDR by the host, not through the
+    // accelerator: AXI-Lite and bulk-load weight writes are dropped and
+    // flagged in STATUS[4]
+    wire weight_write = load_wr_en ? load_weight : (config_reg[8] && (s_axi_awaddr[15:12] == 4'h1));
+    wire weight_write_seen = load_wr_en ? load_weight :
+                             (config_reg[8] && s_axi_awvalid && s_axi_wvalid && (s_axi_awaddr[15:12] == 4'h1));
+    reg  weight_write_rejected;
+    
+    always @(posedge sys_clk) begin
+        if (!sys_rst_n || clear_counters)
+            weight_write_rejected <= 1'b0;
+        else if (WEIGHTS_PAGED && weight_write_seen)
+            weight_write_rejected <= 1'b1;
+    end
+    
     synapse_array #(
         .NUM_AXONS(NUM_AXONS),
         .NUM_NEURONS(NUM_NEURONS),
         .WEIGHT_WIDTH(WEIGHT_WIDTH),
+        .WEIGHT_PRECISION(WEIGHT_PRECISION),
+        .SPARSE(SPARSE_SYNAPSES),
+        .NUM_EDGES(SPARSE_SYNAPSES ? NUM_SYNAPSE_EDGES :
+                   WEIGHT_PAGING ? RESIDENT_PAGES * NUM_NEURONS : NUM_AXONS * NUM_NEURONS),
+        .READ_LANES(SYNAPSE_LANES),
+        .PAGED(WEIGHTS_PAGED),
+        .NUM_PAGES(RESIDENT_PAGES),
+        .PREFETCH_DEPTH(WEIGHT_PREFETCH),
         .USE_BRAM(1)
     ) synapse_array_inst (
         .clk(sys_clk),
         .rst_n(sys_rst_n & ~snn_reset),
         
         // Input spike
-        .spike_in_valid(input_spike_valid),
-        .spike_in_axon_id(input_spike_neuron_id[AXON_ID_WIDTH-1:0]),
+        .spike_in_valid(synapse_in_valid),
+        .spike_in_axon_id(synapse_in_axon),
+        .spike_in_ready(synapse_in_ready),
         
         // Output to neurons
         .spike_out_valid(routed_spike_valid),
         .spike_out_neuron_id(routed_spike_dest_id),
         .spike_out_weight(routed_spike_weight),
         .spike_out_exc_inh(routed_spike_exc_inh),
+        .spike_out_ready(routed_spike_ready),
+        
+        // Weight configuration (AXI-Lite or bulk load)
+        .weight_we(weight_write && !WEIGHTS_PAGED),
+        .weight_addr_axon(load_wr_en ? load_wr_addr[NEURON_ID_WIDTH +: AXON_ID_WIDTH]
+                                     : s_axi_awaddr[AXON_ID_WIDTH+7:8]),
+        .weight_addr_neuron(load_wr_en ? load_wr_addr[NEURON_ID_WIDTH-1:0] : s_axi_awaddr[7:0]),
+        .weight_data(load_wr_en ? load_wr_data[8:0] : {s_axi_wdata[8], s_axi_wdata[7:0]}),
+        
+        // Per-axon scale configuration
+        .scale_we(load_wr_en ? load_scale : (config_reg[8] && (s_axi_awaddr[15:12] == 4'h4))),
+        .scale_addr_axon(load_wr_en ? load_wr_addr[AXON_ID_WIDTH-1:0] : s_axi_awaddr[AXON_ID_WIDTH-1:0]),
+        .scale_data(load_wr_en ? load_wr_data[2:0] : s_axi_wdata[2:0]),
+        
+        // CSR synapse list and row pointers
+        .edge_we(load_wr_en ? load_edge : (config_reg[8] && (s_axi_awaddr[15:12] == 4'h5))),
+        .edge_addr(load_wr_en ? load_wr_addr[11:0] : s_axi_awaddr[11:0]),
+        .edge_data(load_wr_en ? {load_wr_data[16 +: NEURON_ID_WIDTH], load_wr_data[8:0]}
+                              : {s_axi_wdata[16 +: NEURON_ID_WIDTH], s_axi_wdata[8:0]}),
+        .row_ptr_we(load_wr_en ? load_row_ptr : (config_reg[8] && (s_axi_awaddr[15:12] == 4'h6))),
+        .row_ptr_addr(load_wr_en ? load_wr_addr[AXON_ID_WIDTH:0] : s_axi_awaddr[AXON_ID_WIDTH:0]),
+        .row_ptr_data(load_wr_en ? load_wr_data[12:0] : s_axi_wdata[12:0]),
         
-        // Weight configuration
-        .weight_we(config_reg[8] && (s_axi_awaddr[15:12] == 4'h1)),
-        .weight_addr_axon(s_axi_awaddr[AXON_ID_WIDTH+7:8]),
-        .weight_addr_neuron(s_axi_awaddr[7:0]),
-        .weight_data({s_axi_wdata[8], s_axi_wdata[7:0]}),
+        // Weight paging: rows come back as packed {sign, code} entries
+        .page_req_valid(page_req_valid),
+        .page_req_axon(page_req_axon),
+        .page_req_ready(m_axis_page_cmd_tready),
+        .page_fill_valid(s_axis_page_tvalid),
+        .page_fill_data(s_axis_page_tdata),
+        .page_fill_ready(s_axis_page_tready),
+        .page_miss(page_miss),
+        .page_stall(page_stall),
         
         .enable(snn_enable)
     );
     
-    assign input_spike_ready = 1'b1; // Always ready for now
+    // DataMover MM2S command for one weight row: {rsvd, tag, SADDR, DRR,
+    // EOF, DSA, type = INCR, BTT}. Row a lives at page_base + a * row bytes.
+    // A row packs {sign, code} entries densely, neuron n in word
+    // n / PAGE_WORD_CODES at entry n % PAGE_WORD_CODES from the low bits:
+    // 3 9-bit, 8 4-bit or 16 ternary entries per word.
+    localparam PAGE_ENTRY_BITS = (WEIGHT_PRECISION == 2) ? 2 : (WEIGHT_PRECISION == 1) ? 4 : WEIGHT_WIDTH + 1;
+    localparam PAGE_WORD_CODES = 32 / PAGE_ENTRY_BITS;
+    localparam PAGE_ROW_BYTES  = ((NUM_NEURONS + PAGE_WORD_CODES - 1) / PAGE_WORD_CODES) * 4;
+    
+    wire [31:0] page_saddr = page_base + page_req_axon * PAGE_ROW_BYTES;
+    
+    assign m_axis_page_cmd_tdata  = {4'd0, 4'd0, page_saddr, 1'b0, 1'b1, 6'd0, 1'b1, PAGE_ROW_BYTES[22:0]};
+    assign m_axis_page_cmd_tvalid = page_req_valid;
+    
+    // Paging counters, cleared with the other counters
+    always @(posedge sys_clk) begin
+        if (!sys_rst_n || clear_counters) begin
+            page_miss_count <= 32'd0;
+            page_stall_count <= 32'd0;
+        end else begin
+            if (page_miss) page_miss_count <= page_miss_count + 1'b1;
+            if (page_stall) page_stall_count <= page_stall_count + 1'b1;
+        end
+    end
     
     //-------------------------------------------------------------------------
     // LIF Neuron Array
@@ -268,7 +538,8 @@ module snn_accelerator_top #(
         .WEIGHT_WIDTH(WEIGHT_WIDTH),
         .THRESHOLD_WIDTH(THRESHOLD_WIDTH),
         .LEAK_WIDTH(LEAK_WIDTH),
-        .REFRAC_WIDTH(REFRAC_WIDTH)
+        .REFRAC_WIDTH(REFRAC_WIDTH),
+        .INPUT_LANES(SYNAPSE_LANES)
     ) neuron_array_inst (
         .clk(sys_clk),
         .rst_n(sys_rst_n & ~snn_reset),
@@ -286,10 +557,20 @@ module snn_accelerator_top #(
         .m_axis_spike_neuron_id(neuron_spike_id),
         .m_axis_spike_ready(neuron_spike_ready),
         
-        // Configuration
-        .config_we(config_reg[9] && (s_axi_awaddr[15:12] == 4'h2)),
-        .config_addr(s_axi_awaddr[NEURON_ID_WIDTH-1:0]),
-        .config_data(s_axi_wdata),
+        // Bitmap output (unused with BITMAP_OUTPUT = 0)
+        .m_axis_bitmap_valid(),
+        .m_axis_bitmap_data(),
+        .m_axis_bitmap_timestep(),
+        .m_axis_bitmap_ready(1'b1),
+        
+        // Configuration (AXI-Lite or bulk load)
+        .config_we(load_wr_en ? load_neuron : (config_reg[9] && (s_axi_awaddr[15:12] == 4'h2))),
+        .config_addr(load_wr_en ? load_wr_addr[NEURON_ID_WIDTH-1:0] : s_axi_awaddr[NEURON_ID_WIDTH-1:0]),
+        .config_data(load_wr_en ? load_wr_data : s_axi_wdata),
+        
+        // Snapshot read port
+        .state_rd_addr(snapshot_rd_addr),
+        .state_rd_data(snapshot_rd_data),
         
         // Parameters
         .global_threshold(threshold),
@@ -301,22 +582,55 @@ module snn_accelerator_top #(
         .array_busy(array_busy)
     );
     
+    //-------------------------------------------------------------------------
+    // Neuron State Snapshot
+    //-------------------------------------------------------------------------
+    // Streams membrane potentials and refractory counters out as a
+    // LOAD_NEURONS packet. DMA it to DDR to checkpoint; DMA the same buffer
+    // into s_axis_load to restore. Clear ctrl_reg[0] first so the leak and
+    // spike updates do not move the state mid-snapshot.
+    state_dumper #(
+        .DATA_WIDTH(32),
+        .ADDR_WIDTH(NEURON_ID_WIDTH)
+    ) state_dumper_inst (
+        .clk(sys_clk),
+        .rst_n(sys_rst_n),
+        
+        .start(snapshot_start),
+        .target(LOAD_NEURONS),
+        .count(NUM_NEURONS),
+        
+        .rd_addr(snapshot_rd_addr),
+        .rd_data(snapshot_rd_data),
+        
+        .m_axis_tdata(m_axis_state_tdata),
+        .m_axis_tvalid(m_axis_state_tvalid),
+        .m_axis_tready(m_axis_state_tready),
+        .m_axis_tlast(m_axis_state_tlast),
+        
+        .dump_busy(snapshot_busy),
+        .dump_done(snapshot_done)
+    );
+    
     //-------------------------------------------------------------------------
     // Spike Router
     //-------------------------------------------------------------------------
-    spike_router #(
+    // The output goes to a single-lane stream, so the banks share one lane
+    spike_router_banked #(
         .NUM_NEURONS(NUM_NEURONS),
         .MAX_FANOUT(32),
         .WEIGHT_WIDTH(WEIGHT_WIDTH),
+        .NUM_BANKS(ROUTER_BANKS),
+        .OUT_LANES(1),
         .FIFO_DEPTH(ROUTER_BUFFER_DEPTH)
     ) spike_router_inst (
         .clk(sys_clk),
         .rst_n(sys_rst_n & ~snn_reset),
         
-        // Input from neurons
-        .s_spike_valid(neuron_spike_valid),
+        // Input from neurons (taken together with the AER port)
+        .s_spike_valid(neuron_spike_valid && aer_local_ready),
         .s_spike_neuron_id(neuron_spike_id),
-        .s_spike_ready(neuron_spike_ready),
+        .s_spike_ready(router_in_ready),
         
         // Output (loopback to synapses or to PS)
         .m_spike_valid(output_spike_valid),
@@ -325,30 +639,117 @@ module snn_accelerator_top #(
         .m_spike_exc_inh(),
         .m_spike_ready(output_spike_ready),
         
-        // Configuration
-        .config_we(config_reg[10] && (s_axi_awaddr[15:12] == 4'h3)),
-        .config_addr(s_axi_awaddr),
-        .config_data(s_axi_wdata),
+        // Configuration (AXI-Lite or bulk load; counts live in region 8'h01,
+        // row bases in 8'h03, both banked by neuron id; connection words
+        // carry their bank in load address bits [23:16])
+        .config_we(load_wr_en ? load_router : (config_reg[10] && (s_axi_awaddr[15:12] == 4'h3))),
+        .config_addr(load_wr_en ? {((load_wr_target == LOAD_FANOUT)    ? 8'h01 :
+                                    (load_wr_target == LOAD_CONN_BASE) ? 8'h03 : 8'h00),
+                                   load_wr_addr[23:16], load_wr_addr[15:0]}
+                                : s_axi_awaddr),
+        .config_data(load_wr_en ? load_wr_data : s_axi_wdata),
         .config_readdata(),
         
+        // Overflow policy: block (default), drop newest, drop oldest, sample
+        .overflow_policy(router_policy[1:0]),
+        .sample_shift(router_policy[7:4]),
+        .shed_threshold(router_policy[31:16]),
+        
         // Status
+        .clear_stats(clear_counters),
         .routed_spike_count(routed_spike_count),
         .router_busy(router_busy),
-        .fifo_overflow(fifo_overflow)
+        .fifo_overflow(fifo_overflow),
+        .drop_newest_count(router_drop_newest),
+        .drop_oldest_count(router_drop_oldest),
+        .drop_sampled_count(router_drop_sampled),
+        .stall_cycles(router_stalls),
+        .peak_occupancy(router_peak)
+    );
+    
+    //-------------------------------------------------------------------------
+    // AER Tile Port
+    //-------------------------------------------------------------------------
+    // Each neuron spike goes to the local router and, when its export entry
+    // names other tiles, onto the tile ring as one multicast packet. Export
+    // entries are written like router connections, in region 4'h7.
+    assign neuron_spike_ready = router_in_ready && aer_local_ready;
+    
+    aer_tile_port #(
+        .NUM_NEURONS(NUM_NEURONS),
+        .AXON_ID_WIDTH(AXON_ID_WIDTH),
+        .TILE_ID(TILE_ID)
+    ) aer_tile_port_inst (
+        .clk(sys_clk),
+        .rst_n(sys_rst_n & ~snn_reset),
+        
+        // Local spikes
+        .local_spike_valid(neuron_spike_valid && router_in_ready),
+        .local_spike_id(neuron_spike_id),
+        .local_spike_ready(aer_local_ready),
+        
+        // Remote spikes for this tile
+        .import_valid(aer_import_valid),
+        .import_axon(aer_import_axon),
+        .import_ready(synapse_in_ready),
+        
+        // Tile ring
+        .s_axis_aer_tdata(s_axis_aer_tdata),
+        .s_axis_aer_tvalid(s_axis_aer_tvalid),
+        .s_axis_aer_tready(s_axis_aer_tready),
+        .s_axis_aer_tlast(s_axis_aer_tlast),
+        .m_axis_aer_tdata(m_axis_aer_tdata),
+        .m_axis_aer_tvalid(m_axis_aer_tvalid),
+        .m_axis_aer_tready(m_axis_aer_tready),
+        .m_axis_aer_tlast(m_axis_aer_tlast),
+        
+        // Export table (AXI-Lite or bulk load)
+        .config_we(load_wr_en ? load_aer : (config_reg[10] && (s_axi_awaddr[15:12] == 4'h7))),
+        .config_addr(load_wr_en ? load_wr_addr[NEURON_ID_WIDTH-1:0] : s_axi_awaddr[NEURON_ID_WIDTH-1:0]),
+        .config_data(load_wr_en ? load_wr_data : s_axi_wdata),
+        
+        // Status
+        .clear_counters(clear_counters),
+        .exported_count(aer_exported_count),
+        .imported_count(aer_imported_count),
+        .returned_count(aer_returned_count),
+        .port_busy(aer_busy)
     );
     
     //-------------------------------------------------------------------------
     // Status Register Assembly
     //-------------------------------------------------------------------------
+    // Bulk load completion flag, cleared with the counters
+    reg load_complete;
+    always @(posedge sys_clk) begin
+        if (!sys_rst_n || clear_counters)
+            load_complete <= 1'b0;
+        else if (load_done)
+            load_complete <= 1'b1;
+    end
+    
+    // Snapshot completion flag, cleared with the counters
+    reg snapshot_complete;
+    always @(posedge sys_clk) begin
+        if (!sys_rst_n || clear_counters)
+            snapshot_complete <= 1'b0;
+        else if (snapshot_done)
+            snapshot_complete <= 1'b1;
+    end
+    
     assign status_reg = {
-        16'd0,                    // [31:16] Reserved
-        fifo_overflow,           // [15]    FIFO overflow
-        router_busy,             // [14]    Router busy
+        load_words[15:0],        // [31:16] Words written by the last bulk load
+        fifo_overflow,           // [15]    Router shed a spike since the last clear
+        router_busy | aer_busy,  // [14]    Router or tile link busy
         array_busy,              // [13]    Neuron array busy
-        1'b0,                    // [12]    Reserved
-        4'd0,                    // [11:8]  Reserved
+        load_busy,               // [12]    Bulk load in progress
+        load_error,              // [11]    Last bulk load carried no data
+        load_complete,           // [10]    A bulk load finished since the last clear
+        snapshot_busy,           // [9]     State snapshot in progress
+        snapshot_complete,       // [8]     A snapshot finished since the last clear
         |neuron_spike_count[7:0], // [7]     Spike activity
-        3'd0,                    // [6:4]   Reserved
+        2'd0,                    // [6:5]   Reserved
+        weight_write_rejected,   // [4]     Weight write dropped: weights are paged from DDR
         output_spike_valid,      // [3]     Output spike present
         neuron_spike_valid,      // [2]     Neuron spike present
         input_spike_valid,       // [1]     Input spike present
@@ -384,7 +785,7 @@ module snn_accelerator_top #(
             end
             
             // Update threshold
-            if (config_reg[11] && (s_axi_awaddr[7:0] == 8'h20))
+            if (config_reg[11] && (s_axi_awaddr[15:12] == 4'h0) && (s_axi_awaddr[7:0] == 8'h20))
                 spike_threshold <= s_axi_wdata[15:0];
         end
     end
@@ -410,7 +811,7 @@ module snn_accelerator_top #(
     // RGB LED 4 - System status
     assign led4_g = snn_enable & ~snn_reset;            // Green: running
     assign led4_r = snn_reset;                          // Red: reset
-    assign led4_b = array_busy | router_busy;           // Blue: busy
+    assign led4_b = array_busy | router_busy | aer_busy; // Blue: busy
     
     // RGB LED 5 - Activity indicator
     reg [15:0] activity_pwm;
@@ -61,7 +61,10 @@ usage() {
     echo "Available testbenches:"
     echo "  tb_top          - Top level system testbench"
     echo "  tb_lif_neuron   - LIF neuron testbench"
+    echo "  tb_lif_neuron_array - LIF neuron array testbench"
     echo "  tb_spike_router - Spike router testbench"
+    echo "  tb_spike_router_banked - Banked router throughput testbench"
+    echo "  tb_aer_ring     - Four-tile AER ring testbench"
     echo ""
     echo "Examples:"
     echo "  $0                      # Run default testbench (tb_top)"
@@ -125,6 +128,8 @@ COMMON_SOURCES=(
     "$RTL_DIR/common/reset_sync.v"
     "$RTL_DIR/common/fifo.v"
     "$RTL_DIR/common/sync_pulse.v"
+    "$RTL_DIR/common/stream_loader.v"
+    "$RTL_DIR/common/state_dumper.v"
 )
 
 # Core modules
@@ -134,6 +139,8 @@ CORE_SOURCES=(
     "$RTL_DIR/synapses/synapse_array.v"
     "$RTL_DIR/synapses/weight_memory.v"
     "$RTL_DIR/router/spike_router.v"
+    "$RTL_DIR/router/spike_router_banked.v"
+    "$RTL_DIR/router/aer_tile_port.v"
     "$RTL_DIR/interfaces/axi_wrapper.v"
     "$RTL_DIR/top/snn_accelerator_top.v"
 )
@@ -150,6 +157,12 @@ case $TB_TOP in
         # Only need neuron-related files
         CORE_SOURCES=("$RTL_DIR/neurons/lif_neuron.v")
         ;;
+    tb_lif_neuron_array)
+        TB_FILE="$TB_DIR/tb_lif_neuron_array.v"
+        SNAPSHOT_NAME="tb_lif_neuron_array_snapshot"
+        # Only need the neuron array
+        CORE_SOURCES=("$RTL_DIR/neurons/lif_neuron_array.v")
+        ;;
     tb_spike_router)
         TB_FILE="$TB_DIR/tb_spike_router.v"
         SNAPSHOT_NAME="tb_spike_router_snapshot"
@@ -159,6 +172,25 @@ case $TB_TOP in
             "$RTL_DIR/common/fifo.v"
         )
         ;;
+    tb_spike_router_banked)
+        TB_FILE="$TB_DIR/tb_spike_router_banked.v"
+        SNAPSHOT_NAME="tb_spike_router_banked_snapshot"
+        # Only need the banked router, its banks and FIFO
+        CORE_SOURCES=(
+            "$RTL_DIR/router/spike_router_banked.v"
+            "$RTL_DIR/router/spike_router.v"
+            "$RTL_DIR/common/fifo.v"
+        )
+        ;;
+    tb_aer_ring)
+        TB_FILE="$TB_DIR/tb_aer_ring.v"
+        SNAPSHOT_NAME="tb_aer_ring_snapshot"
+        # Only need the tile port and FIFO
+        CORE_SOURCES=(
+            "$RTL_DIR/router/aer_tile_port.v"
+            "$RTL_DIR/common/fifo.v"
+        )
+        ;;
     *)
         print_error "Unknown testbench: $TB_TOP"
         exit 1
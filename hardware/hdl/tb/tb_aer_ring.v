@@ -0,0 +1,362 @@
+//-----------------------------------------------------------------------------
+// Title         : Testbench for AER Tile Ring
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : tb_aer_ring.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Four AER tile ports closed into a ring; checks unicast,
+//                 multicast, undeliverable packets and backpressure
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+module tb_aer_ring();
+
+    // Parameters
+    localparam NUM_TILES        = 4;
+    localparam NUM_NEURONS      = 64;
+    localparam NEURON_ID_WIDTH  = $clog2(NUM_NEURONS);
+    localparam AXON_ID_WIDTH    = 6;
+    
+    // Clock period (100MHz)
+    localparam CLK_PERIOD = 10;
+    
+    // DUT signals
+    reg                         clk;
+    reg                         rst_n;
+    
+    // Local spikes, one port per tile
+    reg  [NUM_TILES-1:0]                 local_valid;
+    reg  [NUM_TILES*NEURON_ID_WIDTH-1:0] local_id;
+    wire [NUM_TILES-1:0]                 local_ready;
+    
+    // Imported spikes
+    wire [NUM_TILES-1:0]                 import_valid;
+    wire [NUM_TILES*AXON_ID_WIDTH-1:0]   import_axon;
+    reg  [NUM_TILES-1:0]                 import_ready;
+    
+    // Ring links: link t runs from tile t to tile t+1
+    wire [31:0]                 link_data  [0:NUM_TILES-1];
+    wire [NUM_TILES-1:0]        link_valid;
+    wire [NUM_TILES-1:0]        link_ready;
+    wire [NUM_TILES-1:0]        link_last;
+    
+    // Export table configuration
+    reg  [NUM_TILES-1:0]        config_we;
+    reg  [NEURON_ID_WIDTH-1:0]  config_addr;
+    reg  [31:0]                 config_data;
+    
+    // Status
+    reg                         clear_counters;
+    wire [31:0]                 exported_count [0:NUM_TILES-1];
+    wire [31:0]                 imported_count [0:NUM_TILES-1];
+    wire [31:0]                 returned_count [0:NUM_TILES-1];
+    wire [NUM_TILES-1:0]        port_busy;
+    
+    // Test variables
+    integer                     test_num;
+    integer                     error_count;
+    integer                     i, t;
+    reg  [NUM_TILES-1:0]        taken;
+    reg [255:0]                 test_name;
+    
+    // Imported spikes per tile and axon
+    integer                     received [0:NUM_TILES*NUM_NEURONS-1];
+    integer                     expected [0:NUM_TILES*NUM_NEURONS-1];
+    
+    //-------------------------------------------------------------------------
+    // DUT Instantiation
+    //-------------------------------------------------------------------------
+    genvar g;
+    generate
+        for (g = 0; g < NUM_TILES; g = g + 1) begin : tile
+            aer_tile_port #(
+                .NUM_NEURONS(NUM_NEURONS),
+                .AXON_ID_WIDTH(AXON_ID_WIDTH),
+                .TILE_ID(g),
+                .EXPORT_FIFO_DEPTH(16)
+            ) DUT (
+                .clk(clk),
+                .rst_n(rst_n),
+                .local_spike_valid(local_valid[g]),
+                .local_spike_id(local_id[g*NEURON_ID_WIDTH +: NEURON_ID_WIDTH]),
+                .local_spike_ready(local_ready[g]),
+                .import_valid(import_valid[g]),
+                .import_axon(import_axon[g*AXON_ID_WIDTH +: AXON_ID_WIDTH]),
+                .import_ready(import_ready[g]),
+                .s_axis_aer_tdata(link_data[(g + NUM_TILES - 1) % NUM_TILES]),
+                .s_axis_aer_tvalid(link_valid[(g + NUM_TILES - 1) % NUM_TILES]),
+                .s_axis_aer_tready(link_ready[(g + NUM_TILES - 1) % NUM_TILES]),
+                .s_axis_aer_tlast(link_last[(g + NUM_TILES - 1) % NUM_TILES]),
+                .m_axis_aer_tdata(link_data[g]),
+                .m_axis_aer_tvalid(link_valid[g]),
+                .m_axis_aer_tready(link_ready[g]),
+                .m_axis_aer_tlast(link_last[g]),
+                .config_we(config_we[g]),
+                .config_addr(config_addr),
+                .config_data(config_data),
+                .clear_counters(clear_counters),
+                .exported_count(exported_count[g]),
+                .imported_count(imported_count[g]),
+                .returned_count(returned_count[g]),
+                .port_busy(port_busy[g])
+            );
+            
+            // Import monitoring
+            always @(posedge clk) begin
+                if (import_valid[g] && import_ready[g]) begin
+                    received[g*NUM_NEURONS + import_axon[g*AXON_ID_WIDTH +: AXON_ID_WIDTH]] =
+                        received[g*NUM_NEURONS + import_axon[g*AXON_ID_WIDTH +: AXON_ID_WIDTH]] + 1;
+                end
+            end
+        end
+    endgenerate
+    
+    //-------------------------------------------------------------------------
+    // Clock Generation
+    //-------------------------------------------------------------------------
+    initial begin
+        clk = 1'b0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+    
+    //-------------------------------------------------------------------------
+    // Test Tasks
+    //-------------------------------------------------------------------------
+    
+    // Initialize test
+    task init_test(input [255:0] name);
+        begin
+            test_name = name;
+            for (i = 0; i < NUM_TILES*NUM_NEURONS; i = i + 1) begin
+                received[i] = 0;
+                expected[i] = 0;
+            end
+            $display("\n========================================");
+            $display("Test %0d: %0s", test_num, test_name);
+            $display("========================================");
+            test_num = test_num + 1;
+        end
+    endtask
+    
+    // Apply reset
+    task apply_reset();
+        begin
+            @(posedge clk);
+            rst_n = 1'b0;
+            repeat(5) @(posedge clk);
+            rst_n = 1'b1;
+            @(posedge clk);
+        end
+    endtask
+    
+    // Write the export entry of one neuron on one tile
+    task configure_export(
+        input integer tile_id,
+        input [5:0] neuron_id,
+        input [15:0] tile_mask,
+        input [5:0] axon
+    );
+        begin
+            @(posedge clk);
+            config_we[tile_id] = 1'b1;
+            config_addr = neuron_id;
+            config_data = {tile_mask, 10'd0, axon};
+            @(posedge clk);
+            config_we = 0;
+            @(posedge clk);
+            $display("  Tile %0d neuron %0d -> tiles 0x%04x, axon %0d",
+                     tile_id, neuron_id, tile_mask, axon);
+        end
+    endtask
+    
+    // Fire one local neuron on one tile (ready is sampled on the falling
+    // edge, so the spike is taken exactly once)
+    task send_spike(
+        input integer tile_id,
+        input [5:0] neuron_id
+    );
+        begin
+            @(negedge clk);
+            local_valid[tile_id] = 1'b1;
+            local_id[tile_id*NEURON_ID_WIDTH +: NEURON_ID_WIDTH] = neuron_id;
+            while (!local_ready[tile_id]) @(negedge clk);
+            @(posedge clk);
+            #1 local_valid[tile_id] = 1'b0;
+        end
+    endtask
+    
+    // Wait until the ring is empty
+    task wait_idle();
+        begin
+            @(posedge clk);
+            while (|port_busy || |link_valid) @(posedge clk);
+            repeat(4) @(posedge clk);
+        end
+    endtask
+    
+    // Compare imported spikes against the expectation
+    task check_results();
+        integer errors;
+        begin
+            errors = 0;
+            for (i = 0; i < NUM_TILES*NUM_NEURONS; i = i + 1) begin
+                if (received[i] != expected[i]) begin
+                    $display("  ERROR: tile %0d axon %0d expected %0d spikes, got %0d",
+                             i / NUM_NEURONS, i % NUM_NEURONS, expected[i], received[i]);
+                    errors = errors + 1;
+                end
+            end
+            if (errors == 0)
+                $display("Test PASSED");
+            else
+                $display("Test FAILED with %0d errors", errors);
+            error_count = error_count + errors;
+        end
+    endtask
+    
+    //-------------------------------------------------------------------------
+    // Main Test Sequence
+    //-------------------------------------------------------------------------
+    initial begin
+        // Initialize
+        rst_n = 1'b0;
+        local_valid = 0;
+        local_id = 0;
+        import_ready = {NUM_TILES{1'b1}};
+        config_we = 0;
+        config_addr = 0;
+        config_data = 0;
+        clear_counters = 1'b0;
+        test_num = 1;
+        error_count = 0;
+        
+        apply_reset();
+        
+        //---------------------------------------------------------------------
+        // Test 1: Unicast to the tile two hops away
+        //---------------------------------------------------------------------
+        init_test("Unicast");
+        configure_export(0, 3, 16'b0100, 7);
+        send_spike(0, 3);
+        expected[2*NUM_NEURONS + 7] = 1;
+        wait_idle();
+        check_results();
+        
+        //---------------------------------------------------------------------
+        // Test 2: Multicast to every other tile, sent once
+        //---------------------------------------------------------------------
+        init_test("Multicast");
+        clear_counters = 1'b1;
+        @(posedge clk);
+        clear_counters = 1'b0;
+        configure_export(1, 10, 16'b1101, 12);
+        send_spike(1, 10);
+        expected[0*NUM_NEURONS + 12] = 1;
+        expected[2*NUM_NEURONS + 12] = 1;
+        expected[3*NUM_NEURONS + 12] = 1;
+        wait_idle();
+        check_results();
+        if (exported_count[1] != 1) begin
+            $display("  ERROR: multicast sent %0d packets, expected 1", exported_count[1]);
+            error_count = error_count + 1;
+        end
+        
+        //---------------------------------------------------------------------
+        // Test 3: Own tile and unused tiles in the mask
+        //---------------------------------------------------------------------
+        // Tile 3 names itself (dropped when the entry is written) and tile 9,
+        // which is not on the ring; the packet returns to tile 3 and retires.
+        init_test("Undeliverable mask bits");
+        configure_export(3, 5, 16'h0209, 20);
+        send_spike(3, 5);
+        expected[0*NUM_NEURONS + 20] = 1;
+        wait_idle();
+        check_results();
+        if (returned_count[3] != 1) begin
+            $display("  ERROR: returned count %0d, expected 1", returned_count[3]);
+            error_count = error_count + 1;
+        end
+        
+        //---------------------------------------------------------------------
+        // Test 4: Spikes without an export entry stay local
+        //---------------------------------------------------------------------
+        init_test("Local-only spike");
+        t = exported_count[2];
+        send_spike(2, 30);
+        wait_idle();
+        check_results();
+        if (exported_count[2] != t) begin
+            $display("  ERROR: local-only spike was exported");
+            error_count = error_count + 1;
+        end
+        
+        //---------------------------------------------------------------------
+        // Test 5: All tiles broadcast at once under import backpressure
+        //---------------------------------------------------------------------
+        init_test("Concurrent broadcast with backpressure");
+        for (t = 0; t < NUM_TILES; t = t + 1)
+            configure_export(t, 1, 16'h000F, 40 + t);
+        
+        fork
+            begin
+                // Each tile drops its valid once its spike is taken, so
+                // a tile whose export queue is full does not make the
+                // others send duplicates
+                for (i = 0; i < 20; i = i + 1) begin
+                    @(negedge clk);
+                    local_valid = {NUM_TILES{1'b1}};
+                    local_id = {NUM_TILES{6'd1}};
+                    while (local_valid != 0) begin
+                        taken = local_valid & local_ready;
+                        @(posedge clk);
+                        #1 local_valid = local_valid & ~taken;
+                        if (local_valid != 0) @(negedge clk);
+                    end
+                end
+            end
+            begin
+                repeat(200) begin
+                    @(posedge clk);
+                    import_ready = $random;
+                end
+                import_ready = {NUM_TILES{1'b1}};
+            end
+        join
+        
+        for (t = 0; t < NUM_TILES; t = t + 1)
+            for (i = 0; i < NUM_TILES; i = i + 1)
+                if (i != t)
+                    expected[t*NUM_NEURONS + 40 + i] = 20;
+        wait_idle();
+        check_results();
+        
+        //---------------------------------------------------------------------
+        // Test Summary
+        //---------------------------------------------------------------------
+        $display("\n========================================");
+        $display("Test Summary");
+        $display("========================================");
+        $display("Total Tests Run: %0d", test_num - 1);
+        $display("Total Errors: %0d", error_count);
+        for (t = 0; t < NUM_TILES; t = t + 1)
+            $display("Tile %0d: exported %0d, imported %0d, returned %0d",
+                     t, exported_count[t], imported_count[t], returned_count[t]);
+        
+        if (error_count == 0)
+            $display("\nAll tests PASSED!");
+        else
+            $display("\nTests FAILED with %0d errors!", error_count);
+        
+        $display("========================================\n");
+        $finish;
+    end
+    
+    // Timeout
+    initial begin
+        #1000000;
+        $display("\n*** ERROR: Testbench timeout! ***");
+        $finish;
+    end
+
+endmodule
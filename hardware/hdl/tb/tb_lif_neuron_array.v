@@ -0,0 +1,410 @@
+//-----------------------------------------------------------------------------
+// Title         : Testbench for LIF Neuron Array
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : tb_lif_neuron_array.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Compares the lazy-leak array against a per-tick leak model
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+module tb_lif_neuron_array();
+
+    // Parameters matching DUT
+    localparam NUM_NEURONS     = 16;
+    localparam NEURON_ID_WIDTH = 4;
+    localparam DATA_WIDTH      = 16;
+    localparam WEIGHT_WIDTH    = 8;
+    localparam THRESHOLD_WIDTH = 16;
+    localparam LEAK_WIDTH      = 8;
+    localparam REFRAC_WIDTH    = 8;
+    localparam LEAK_PERIOD     = 4;
+    
+    // Reference configuration
+    localparam THRESHOLD       = 300;
+    localparam LEAK_RATE       = 3;
+    localparam REFRAC_PERIOD   = 2;
+    
+    // Clock period (100MHz)
+    localparam CLK_PERIOD = 10;
+    
+    // DUT signals
+    reg                         clk;
+    reg                         rst_n;
+    reg                         enable;
+    
+    reg                         s_axis_spike_valid;
+    reg  [NEURON_ID_WIDTH-1:0]  s_axis_spike_dest_id;
+    reg  [WEIGHT_WIDTH-1:0]     s_axis_spike_weight;
+    reg                         s_axis_spike_exc_inh;
+    wire                        s_axis_spike_ready;
+    
+    wire                        m_axis_spike_valid;
+    wire [NEURON_ID_WIDTH-1:0]  m_axis_spike_neuron_id;
+    
+    reg                         config_we;
+    reg  [NEURON_ID_WIDTH-1:0]  config_addr;
+    reg  [31:0]                 config_data;
+    
+    reg  [NEURON_ID_WIDTH-1:0]  state_rd_addr;
+    wire [31:0]                 state_rd_data;
+    
+    wire [31:0]                 spike_count;
+    wire                        array_busy;
+    
+    // Reference model: every enabled LEAK_PERIOD cycles, each neuron that is
+    // not refractory leaks by one LEAK_RATE step
+    reg  [DATA_WIDTH-1:0]       ref_potential [0:NUM_NEURONS-1];
+    reg  [REFRAC_WIDTH-1:0]     ref_refrac [0:NUM_NEURONS-1];
+    integer                     ref_edges;
+    reg  [DATA_WIDTH-1:0]       ref_before;
+    
+    // Events in flight: the DUT writes an event back two edges after accepting it
+    reg                         pipe_valid [0:1];
+    reg  [NEURON_ID_WIDTH-1:0]  pipe_dest [0:1];
+    reg  [WEIGHT_WIDTH-1:0]     pipe_weight [0:1];
+    reg                         pipe_exc_inh [0:1];
+    
+    // Test variables
+    integer                     test_num;
+    integer                     error_count;
+    integer                     i, n;
+    integer                     spikes_out;
+    reg  [NEURON_ID_WIDTH-1:0]  cfg_dest;
+    reg  [DATA_WIDTH-1:0]       cfg_potential;
+    reg  [REFRAC_WIDTH-1:0]     cfg_refrac;
+    
+    //-------------------------------------------------------------------------
+    // DUT Instantiation
+    //-------------------------------------------------------------------------
+    lif_neuron_array #(
+        .NUM_NEURONS(NUM_NEURONS),
+        .DATA_WIDTH(DATA_WIDTH),
+        .WEIGHT_WIDTH(WEIGHT_WIDTH),
+        .THRESHOLD_WIDTH(THRESHOLD_WIDTH),
+        .LEAK_WIDTH(LEAK_WIDTH),
+        .REFRAC_WIDTH(REFRAC_WIDTH),
+        .LEAK_PERIOD(LEAK_PERIOD)
+    ) DUT (
+        .clk(clk),
+        .rst_n(rst_n),
+        .enable(enable),
+        .s_axis_spike_valid(s_axis_spike_valid),
+        .s_axis_spike_dest_id(s_axis_spike_dest_id),
+        .s_axis_spike_weight(s_axis_spike_weight),
+        .s_axis_spike_exc_inh(s_axis_spike_exc_inh),
+        .s_axis_spike_ready(s_axis_spike_ready),
+        .m_axis_spike_valid(m_axis_spike_valid),
+        .m_axis_spike_neuron_id(m_axis_spike_neuron_id),
+        .m_axis_spike_ready(1'b1),
+        .m_axis_bitmap_valid(),
+        .m_axis_bitmap_data(),
+        .m_axis_bitmap_timestep(),
+        .m_axis_bitmap_ready(1'b1),
+        .config_we(config_we),
+        .config_addr(config_addr),
+        .config_data(config_data),
+        .state_rd_addr(state_rd_addr),
+        .state_rd_data(state_rd_data),
+        .global_threshold(THRESHOLD),
+        .global_leak_rate(LEAK_RATE),
+        .global_refrac_period(REFRAC_PERIOD),
+        .spike_count(spike_count),
+        .array_busy(array_busy)
+    );
+    
+    //-------------------------------------------------------------------------
+    // Clock Generation
+    //-------------------------------------------------------------------------
+    initial begin
+        clk = 1'b0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+    
+    //-------------------------------------------------------------------------
+    // Reference Model
+    //-------------------------------------------------------------------------
+    task ref_event(
+        input [NEURON_ID_WIDTH-1:0] dest,
+        input [WEIGHT_WIDTH-1:0]    weight,
+        input                       exc_inh
+    );
+        reg [DATA_WIDTH:0] v;
+        begin
+            if (ref_refrac[dest] != 0) begin
+                ref_refrac[dest] = ref_refrac[dest] - 1;
+            end else begin
+                if (exc_inh) begin
+                    v = ref_potential[dest] + weight;
+                    if (v > {DATA_WIDTH{1'b1}})
+                        v = {DATA_WIDTH{1'b1}};
+                end else begin
+                    v = (ref_potential[dest] < weight) ? 0 : ref_potential[dest] - weight;
+                end
+                
+                if (v >= THRESHOLD) begin
+                    ref_potential[dest] = 0;
+                    ref_refrac[dest] = REFRAC_PERIOD;
+                end else begin
+                    ref_potential[dest] = v;
+                end
+            end
+        end
+    endtask
+    
+    task ref_tick();
+        integer k;
+        begin
+            for (k = 0; k < NUM_NEURONS; k = k + 1) begin
+                if (ref_refrac[k] == 0) begin
+                    ref_potential[k] = (ref_potential[k] > LEAK_RATE) ?
+                                       ref_potential[k] - LEAK_RATE : 0;
+                end
+            end
+        end
+    endtask
+    
+    // Configuration write on top of this edge's event; a refractory-only
+    // write keeps the potential the neuron had before the edge
+    task ref_config(
+        input [NEURON_ID_WIDTH-1:0] addr,
+        input [31:0]                data,
+        input [DATA_WIDTH-1:0]      before
+    );
+        begin
+            case (data[31:30])
+                2'b00: ref_potential[addr] = data[DATA_WIDTH-1:0];
+                2'b01: begin
+                    ref_potential[addr] = before;
+                    ref_refrac[addr] = data[REFRAC_WIDTH-1:0];
+                end
+                2'b10: begin
+                    ref_potential[addr] = data[DATA_WIDTH-1:0];
+                    ref_refrac[addr] = data[16 +: REFRAC_WIDTH];
+                end
+                default: ;
+            endcase
+        end
+    endtask
+    
+    // Step the model on the same edges as the DUT: the event written back on
+    // an edge is integrated first, then that edge's configuration write
+    // (which wins), then the leak tick
+    always @(posedge clk) begin
+        if (!rst_n) begin
+            ref_edges = 0;
+            for (n = 0; n < NUM_NEURONS; n = n + 1) begin
+                ref_potential[n] = 0;
+                ref_refrac[n] = 0;
+            end
+            pipe_valid[0] = 1'b0;
+            pipe_valid[1] = 1'b0;
+        end else if (enable) begin
+            ref_edges = ref_edges + 1;
+            
+            ref_before = ref_potential[config_addr];
+            if (pipe_valid[1])
+                ref_event(pipe_dest[1], pipe_weight[1], pipe_exc_inh[1]);
+            if (config_we)
+                ref_config(config_addr, config_data, ref_before);
+            if (ref_edges % LEAK_PERIOD == 0)
+                ref_tick();
+            
+            pipe_valid[1] = pipe_valid[0];
+            pipe_dest[1] = pipe_dest[0];
+            pipe_weight[1] = pipe_weight[0];
+            pipe_exc_inh[1] = pipe_exc_inh[0];
+            
+            pipe_valid[0] = s_axis_spike_valid && s_axis_spike_ready;
+            pipe_dest[0] = s_axis_spike_dest_id;
+            pipe_weight[0] = s_axis_spike_weight;
+            pipe_exc_inh[0] = s_axis_spike_exc_inh;
+        end
+    end
+    
+    // Output spike monitor (ready is tied high: one spike per valid cycle)
+    always @(posedge clk) begin
+        if (!rst_n)
+            spikes_out = 0;
+        else if (m_axis_spike_valid)
+            spikes_out = spikes_out + 1;
+    end
+    
+    //-------------------------------------------------------------------------
+    // Test Tasks
+    //-------------------------------------------------------------------------
+    
+    // Apply reset
+    task apply_reset();
+        begin
+            @(negedge clk);
+            rst_n = 1'b0;
+            repeat(5) @(negedge clk);
+            rst_n = 1'b1;
+        end
+    endtask
+    
+    // Present one event for a single cycle
+    task send_event(
+        input [NEURON_ID_WIDTH-1:0] dest,
+        input [WEIGHT_WIDTH-1:0]    weight,
+        input                       exc_inh
+    );
+        begin
+            s_axis_spike_valid = 1'b1;
+            s_axis_spike_dest_id = dest;
+            s_axis_spike_weight = weight;
+            s_axis_spike_exc_inh = exc_inh;
+            @(negedge clk);
+            s_axis_spike_valid = 1'b0;
+        end
+    endtask
+    
+    // Present one configuration write for a single cycle
+    task send_config(
+        input [NEURON_ID_WIDTH-1:0] addr,
+        input [31:0]                data
+    );
+        begin
+            config_we = 1'b1;
+            config_addr = addr;
+            config_data = data;
+            @(negedge clk);
+            config_we = 1'b0;
+        end
+    endtask
+    
+    // Freeze the array (no ticks while disabled) and compare every neuron
+    task compare_state(input [255:0] name);
+        integer errors;
+        integer k;
+        begin
+            repeat(3) @(negedge clk);   // Drain the pipeline
+            enable = 1'b0;
+            @(negedge clk);
+            
+            errors = 0;
+            for (k = 0; k < NUM_NEURONS; k = k + 1) begin
+                state_rd_addr = k;
+                #1;
+                if (state_rd_data[DATA_WIDTH-1:0] != ref_potential[k] ||
+                    state_rd_data[16 +: REFRAC_WIDTH] != ref_refrac[k]) begin
+                    $display("ERROR: Neuron %0d - expected v=%0d r=%0d, got v=%0d r=%0d",
+                             k, ref_potential[k], ref_refrac[k],
+                             state_rd_data[DATA_WIDTH-1:0], state_rd_data[16 +: REFRAC_WIDTH]);
+                    errors = errors + 1;
+                end
+            end
+            
+            if (errors == 0)
+                $display("PASS: %0s - all %0d neurons match the per-tick model", name, NUM_NEURONS);
+            else
+                $display("FAIL: %0s - %0d neurons differ", name, errors);
+            error_count = error_count + errors;
+            
+            @(negedge clk);
+            enable = 1'b1;
+        end
+    endtask
+    
+    //-------------------------------------------------------------------------
+    // Main Test Sequence
+    //-------------------------------------------------------------------------
+    initial begin
+        $display("========================================");
+        $display("LIF Neuron Array Testbench");
+        $display("========================================");
+        
+        rst_n = 1'b1;
+        enable = 1'b1;
+        s_axis_spike_valid = 1'b0;
+        s_axis_spike_dest_id = 0;
+        s_axis_spike_weight = 0;
+        s_axis_spike_exc_inh = 1'b1;
+        config_we = 1'b0;
+        config_addr = 0;
+        config_data = 0;
+        state_rd_addr = 0;
+        test_num = 1;
+        error_count = 0;
+        
+        apply_reset();
+        
+        // Test 1: sparse random events, idle gaps spanning several ticks
+        $display("\nTest %0d: Sparse events", test_num);
+        test_num = test_num + 1;
+        for (i = 0; i < 300; i = i + 1) begin
+            send_event($unsigned($random) % 8, $random, ($unsigned($random) % 4) != 0);
+            repeat($unsigned($random) % 40) @(negedge clk);
+        end
+        compare_state("Sparse events");
+        
+        // Test 2: back-to-back events to one neuron across tick boundaries
+        $display("\nTest %0d: Back-to-back events", test_num);
+        test_num = test_num + 1;
+        for (i = 0; i < 200; i = i + 1) begin
+            send_event(((i / 10) % 2) ? 5 : 6, $random, ($unsigned($random) % 3) != 0);
+        end
+        compare_state("Back-to-back events");
+        
+        // Test 3: long idle period, every potential decays to zero or holds
+        $display("\nTest %0d: Long idle", test_num);
+        test_num = test_num + 1;
+        for (i = 0; i < NUM_NEURONS; i = i + 1) begin
+            send_event(i, 8'd200, 1'b1);
+        end
+        repeat(50) @(negedge clk);
+        compare_state("Partial decay");
+        repeat(2000) @(negedge clk);
+        compare_state("Long idle");
+        
+        // Test 4: every neuron fires in the same tick; none may be dropped
+        $display("\nTest %0d: Dense firing", test_num);
+        test_num = test_num + 1;
+        for (i = 0; i < NUM_NEURONS; i = i + 1) begin
+            send_event(i, 8'd255, 1'b1);
+            send_event(i, 8'd255, 1'b1);
+        end
+        compare_state("Dense firing");
+        repeat(NUM_NEURONS) @(negedge clk);
+        if (spikes_out == spike_count) begin
+            $display("PASS: All %0d fired spikes left the output queue", spike_count);
+        end else begin
+            $display("FAIL: %0d spikes fired, %0d output", spike_count, spikes_out);
+            error_count = error_count + 1;
+        end
+        
+        // Test 5: configuration writes on the edge an event to the same
+        // neuron is written back; the configuration takes priority
+        $display("\nTest %0d: Configuration over write-back", test_num);
+        test_num = test_num + 1;
+        for (i = 0; i < 200; i = i + 1) begin
+            cfg_dest = $unsigned($random) % 8;
+            cfg_potential = $unsigned($random) % 400;
+            cfg_refrac = $unsigned($random) % 4;
+            send_event(cfg_dest, $random, ($unsigned($random) % 4) != 0);
+            @(negedge clk);             // Event in WRITE BACK on the next edge
+            case ($unsigned($random) % 3)
+                0: send_config(cfg_dest, {2'b00, 14'd0, cfg_potential});
+                1: send_config(cfg_dest, {2'b01, 22'd0, cfg_refrac});
+                default: send_config(cfg_dest, {2'b10, 6'd0, cfg_refrac, cfg_potential});
+            endcase
+            repeat($unsigned($random) % 10) @(negedge clk);
+        end
+        compare_state("Configuration over write-back");
+        
+        // Summary
+        $display("\n========================================");
+        $display("Test Summary");
+        $display("========================================");
+        $display("Spikes fired: %0d", spike_count);
+        if (error_count == 0)
+            $display("ALL TESTS PASSED!");
+        else
+            $display("TEST FAILED with %0d errors", error_count);
+        
+        $finish;
+    end
+
+endmodule
@@ -19,6 +19,12 @@ module tb_spike_router();
     localparam DELAY_WIDTH      = 8;
     localparam FIFO_DEPTH       = 256;
     
+    // Overload: with the output stalled, the output register, the FETCH
+    // stage, the active fan-out and the head register hold spikes beyond
+    // the FIFO
+    localparam OVERLOAD_HELD    = 4;
+    localparam OVERLOAD_SPIKES  = FIFO_DEPTH + OVERLOAD_HELD + 36;
+    
     // Clock period (100MHz)
     localparam CLK_PERIOD = 10;
     
@@ -44,16 +50,27 @@ module tb_spike_router();
     reg [31:0]                 config_data;
     wire [31:0]                config_readdata;
     
+    // Overflow policy
+    reg  [1:0]                 overflow_policy;
+    reg  [3:0]                 sample_shift;
+    reg  [15:0]                shed_threshold;
+    
     // Status outputs
     wire [31:0]                routed_spike_count;
     wire                       router_busy;
     wire                       fifo_overflow;
+    wire [31:0]                drop_newest_count;
+    wire [31:0]                drop_oldest_count;
+    wire [31:0]                drop_sampled_count;
+    wire [31:0]                stall_cycles;
+    wire [15:0]                peak_occupancy;
     
     // Test variables
     integer                    test_num;
     integer                    error_count;
     integer                    spike_count;
     integer                    i, j;
+    integer                    sampled;
     reg [255:0]               test_name;
     
     // Tracking arrays
@@ -61,6 +78,8 @@ module tb_spike_router();
     reg [31:0]                received_spikes[0:NUM_NEURONS-1];
     reg [7:0]                 expected_weights[0:NUM_NEURONS-1];
     reg [7:0]                 received_weights[0:NUM_NEURONS-1];
+    time                      arrival_time[0:NUM_NEURONS-1];
+    time                      sent_time;
     
     //-------------------------------------------------------------------------
     // DUT Instantiation
@@ -85,9 +104,18 @@ module tb_spike_router();
         .config_addr(config_addr),
         .config_data(config_data),
         .config_readdata(config_readdata),
+        .overflow_policy(overflow_policy),
+        .sample_shift(sample_shift),
+        .shed_threshold(shed_threshold),
+        .clear_stats(1'b0),
         .routed_spike_count(routed_spike_count),
         .router_busy(router_busy),
-        .fifo_overflow(fifo_overflow)
+        .fifo_overflow(fifo_overflow),
+        .drop_newest_count(drop_newest_count),
+        .drop_oldest_count(drop_oldest_count),
+        .drop_sampled_count(drop_sampled_count),
+        .stall_cycles(stall_cycles),
+        .peak_occupancy(peak_occupancy)
     );
     
     //-------------------------------------------------------------------------
@@ -105,6 +133,7 @@ module tb_spike_router();
         if (m_spike_valid && m_spike_ready) begin
             received_spikes[m_spike_dest_id] = received_spikes[m_spike_dest_id] + 1;
             received_weights[m_spike_dest_id] = m_spike_weight;
+            arrival_time[m_spike_dest_id] = $time;
             $display("[%0t] Output spike: dest=%0d, weight=%0d, exc/inh=%b", 
                      $time, m_spike_dest_id, m_spike_weight, m_spike_exc_inh);
         end
@@ -149,14 +178,14 @@ module tb_spike_router();
         input [5:0] dest_id,
         input [7:0] weight,
         input exc_inh,
-        input [6:0] delay,
+        input [7:0] delay,
         input [15:0] conn_index
     );
         begin
             @(posedge clk);
             config_we = 1'b1;
             config_addr = {8'h00, 16'd0} | conn_index;
-            config_data = {8'd0, 1'b1, exc_inh, weight, delay, 2'd0, dest_id};
+            config_data = {8'd0, 1'b1, exc_inh, weight, delay, dest_id};
             @(posedge clk);
             config_we = 1'b0;
             @(posedge clk);
@@ -182,6 +211,23 @@ module tb_spike_router();
         end
     endtask
     
+    // Configure neuron row base in the packed connection array
+    task configure_neuron_base(
+        input [5:0] neuron_id,
+        input [15:0] base
+    );
+        begin
+            @(posedge clk);
+            config_we = 1'b1;
+            config_addr = {8'h03, 16'd0, 2'd0, neuron_id};
+            config_data = {16'd0, base};
+            @(posedge clk);
+            config_we = 1'b0;
+            @(posedge clk);
+            $display("  Neuron %0d connections start at %0d", neuron_id, base);
+        end
+    endtask
+    
     // Send spike
     task send_spike(input [5:0] neuron_id);
         begin
@@ -195,6 +241,22 @@ module tb_spike_router();
         end
     endtask
     
+    // Check that neuron dest received its delayed spike delay cycles after
+    // it was sent (plus the wheel's drain and output register)
+    task check_arrival(input [5:0] dest, input integer delay);
+        integer cycles;
+        begin
+            cycles = (arrival_time[dest] - sent_time) / CLK_PERIOD;
+            $display("  Spike to neuron %0d arrived %0d cycles after it was sent (delay %0d)",
+                     dest, cycles, delay);
+            if (received_spikes[dest] == 0 || cycles < delay || cycles > delay + 2) begin
+                $display("  ERROR: expected the spike %0d-%0d cycles after it was sent",
+                         delay, delay + 2);
+                error_count = error_count + 1;
+            end
+        end
+    endtask
+    
     // Wait with timeout
     task wait_with_timeout(input integer cycles);
         integer k;
@@ -203,9 +265,182 @@ module tb_spike_router();
                 @(posedge clk);
                 if (!router_busy) begin
                     repeat(10) @(posedge clk);
-                    break;
+                    k = cycles;
+                end
+            end
+        end
+    endtask
+    
+    // Read a router statistic through the config readback port
+    task read_stat(
+        input [7:0] addr,
+        output [31:0] value
+    );
+        begin
+            config_addr = {addr, 24'd0};
+            @(posedge clk);
+            @(posedge clk);
+            value = config_readdata;
+        end
+    endtask
+    
+    // Check one overload counter read back at addr against the expected
+    // value and the matching status output
+    task check_stat(
+        input [7:0] addr,
+        input [31:0] port_value,
+        input [31:0] expected
+    );
+        reg [31:0] value;
+        begin
+            read_stat(addr, value);
+            if (value != expected || value != port_value) begin
+                $display("  ERROR: counter 8'h%02x reads %0d (port %0d), expected %0d",
+                         addr, value, port_value, expected);
+                error_count = error_count + 1;
+            end
+        end
+    endtask
+    
+    // Overload neuron 0 (one connection) with the output stalled, then
+    // release it; every spike must be routed or counted as shed, and the
+    // counters at 8'h14-8'h18 must match the expected drops and peak
+    task run_overload(
+        input [1:0] policy,
+        input [3:0] shift,
+        input [15:0] mark,
+        input integer spikes,
+        input integer exp_newest,
+        input integer exp_oldest,
+        input integer exp_sampled,
+        input integer exp_peak
+    );
+        integer shed;
+        reg [31:0] stalls;
+        begin
+            apply_reset();
+            overflow_policy = policy;
+            sample_shift = shift;
+            shed_threshold = mark;
+            configure_connection(0, 1, 8'd20, 1'b1, 7'd0, 16'd0);
+            configure_neuron_count(0, 8'd1);
+            
+            // Hold valid like the neuron array does; ready is sampled on the
+            // falling edge, so each counted spike is taken at the next rise
+            m_spike_ready = 1'b0;
+            fork
+                begin
+                    @(negedge clk);
+                    s_spike_valid = 1'b1;
+                    s_spike_neuron_id = 0;
+                    j = 0;
+                    while (j < spikes) begin
+                        if (s_spike_ready)
+                            j = j + 1;
+                        @(negedge clk);
+                    end
+                    s_spike_valid = 1'b0;
+                end
+                begin
+                    repeat(FIFO_DEPTH * 3) @(posedge clk);
+                    m_spike_ready = 1'b1;
+                end
+            join
+            wait_with_timeout(FIFO_DEPTH * 4);
+            
+            shed = drop_newest_count + drop_oldest_count + drop_sampled_count;
+            $display("  Routed %0d, dropped newest %0d, oldest %0d, sampled %0d",
+                     routed_spike_count, drop_newest_count, drop_oldest_count, drop_sampled_count);
+            $display("  Stall cycles %0d, peak FIFO occupancy %0d", stall_cycles, peak_occupancy);
+            if (routed_spike_count + shed != spikes) begin
+                $display("  ERROR: %0d spikes sent, %0d routed + %0d shed",
+                         spikes, routed_spike_count, shed);
+                error_count = error_count + 1;
+            end
+            
+            check_stat(8'h14, drop_newest_count, exp_newest);
+            check_stat(8'h15, drop_oldest_count, exp_oldest);
+            check_stat(8'h16, drop_sampled_count, exp_sampled);
+            check_stat(8'h18, peak_occupancy, exp_peak);
+            
+            // Only the blocking policy holds the neurons off
+            read_stat(8'h17, stalls);
+            if (stalls != stall_cycles || (policy == 2'd0) != (stalls != 0)) begin
+                $display("  ERROR: %0d stall cycles (port %0d) under policy %0d",
+                         stalls, stall_cycles, policy);
+                error_count = error_count + 1;
+            end
+            if ((policy != 2'd0) != fifo_overflow) begin
+                $display("  ERROR: overflow flag should be set only when spikes are shed");
+                error_count = error_count + 1;
+            end
+            
+            overflow_policy = 2'd0;
+            sample_shift = 4'd0;
+            shed_threshold = 16'd0;
+        end
+    endtask
+    
+    // Fire back-to-back spikes from neurons 0-3, each with MAX_FANOUT
+    // undelayed connections, and measure routed events per cycle from the
+    // first routed event to the last
+    task run_throughput(input integer spikes);
+        integer events, cycle, first_cycle, last_cycle, rate_x100;
+        begin
+            apply_reset();
+            for (i = 0; i < 4; i = i + 1) begin
+                for (j = 0; j < MAX_FANOUT; j = j + 1) begin
+                    configure_connection(i, (i + j) % NUM_NEURONS, 8'd7, 1'b1, 8'd0,
+                                         i*MAX_FANOUT + j);
+                    expected_spikes[(i + j) % NUM_NEURONS] =
+                        expected_spikes[(i + j) % NUM_NEURONS] + spikes / 4;
+                    expected_weights[(i + j) % NUM_NEURONS] = 7;
                 end
+                configure_neuron_count(i, MAX_FANOUT);
             end
+            
+            events = 0;
+            cycle = 0;
+            first_cycle = 0;
+            last_cycle = 0;
+            fork
+                begin
+                    // Hold valid and step the source whenever a spike is taken
+                    @(negedge clk);
+                    s_spike_valid = 1'b1;
+                    j = 0;
+                    while (j < spikes) begin
+                        s_spike_neuron_id = j % 4;
+                        if (s_spike_ready)
+                            j = j + 1;
+                        @(negedge clk);
+                    end
+                    s_spike_valid = 1'b0;
+                end
+                begin
+                    while (events < spikes * MAX_FANOUT) begin
+                        @(posedge clk);
+                        cycle = cycle + 1;
+                        if (m_spike_valid && m_spike_ready) begin
+                            if (events == 0)
+                                first_cycle = cycle;
+                            events = events + 1;
+                            last_cycle = cycle;
+                        end
+                    end
+                end
+            join
+            wait_with_timeout(100);
+            
+            rate_x100 = (events * 100) / (last_cycle - first_cycle + 1);
+            $display("  %0d spikes x %0d connections: %0d events in %0d cycles, %0d.%02d events/cycle",
+                     spikes, MAX_FANOUT, events, last_cycle - first_cycle + 1,
+                     rate_x100 / 100, rate_x100 % 100);
+            if (rate_x100 < 95) begin
+                $display("  ERROR: back-to-back fan-out should route one event per cycle");
+                error_count = error_count + 1;
+            end
+            verify_results();
         end
     endtask
     
@@ -224,7 +459,7 @@ module tb_spike_router();
                         $display("ERROR: Neuron %0d - Expected weight %0d, got %0d", 
                                  i, expected_weights[i], received_weights[i]);
                         errors = errors + 1;
-                    } end else begin
+                    end else begin
                         $display("PASS: Neuron %0d - Correctly received %0d spikes with weight %0d", 
                                  i, received_spikes[i], received_weights[i]);
                     end
@@ -252,6 +487,9 @@ module tb_spike_router();
         config_we = 1'b0;
         config_addr = 0;
         config_data = 0;
+        overflow_policy = 2'd0;
+        sample_shift = 4'd0;
+        shed_threshold = 16'd0;
         test_num = 1;
         error_count = 0;
         
@@ -290,6 +528,7 @@ module tb_spike_router();
         configure_connection(5, 11, 8'd40, 1'b1, 7'd0, 16'd41);
         configure_connection(5, 12, 8'd50, 1'b0, 7'd0, 16'd42);  // Inhibitory
         configure_connection(5, 13, 8'd60, 1'b1, 7'd0, 16'd43);
+        configure_neuron_base(5, 16'd40);
         configure_neuron_count(5, 8'd4);
         
         expected_spikes[10] = 1; expected_weights[10] = 30;
@@ -305,17 +544,20 @@ module tb_spike_router();
         //---------------------------------------------------------------------
         // Test 3: Many-to-One Routing (Convergence)
         //---------------------------------------------------------------------
-        init_test("Many-to-One Routing (Convergence)");
+        init_test("Many-to-One Routing (Converge)");
         apply_reset();
         
         // Configure neurons 20, 21, 22 to all connect to neuron 30
         configure_connection(20, 30, 8'd20, 1'b1, 7'd0, 16'd80);
+        configure_neuron_base(20, 16'd80);
         configure_neuron_count(20, 8'd1);
         
         configure_connection(21, 30, 8'd25, 1'b1, 7'd0, 16'd81);
+        configure_neuron_base(21, 16'd81);
         configure_neuron_count(21, 8'd1);
         
         configure_connection(22, 30, 8'd30, 1'b1, 7'd0, 16'd82);
+        configure_neuron_base(22, 16'd82);
         configure_neuron_count(22, 8'd1);
         
         expected_spikes[30] = 3;
@@ -334,36 +576,50 @@ module tb_spike_router();
         init_test("Delayed Spike Routing");
         apply_reset();
         
-        // Configure connections with different delays
-        configure_connection(40, 50, 8'd80, 1'b1, 7'd10, 16'd120);  // 10 cycle delay
-        configure_connection(40, 51, 8'd81, 1'b1, 7'd50, 16'd121);  // 50 cycle delay
-        configure_connection(40, 52, 8'd82, 1'b1, 7'd100, 16'd122); // 100 cycle delay
-        configure_neuron_count(40, 8'd3);
-        
-        // Track when spikes are sent
-        fork
-            begin
-                send_spike(40);
-                $display("  Spike sent at time %0t", $time);
-            end
-            
-            begin
-                // Monitor for delayed outputs
-                @(posedge m_spike_valid);
-                while (m_spike_dest_id != 50) @(posedge m_spike_valid);
-                $display("  Spike to neuron 50 arrived at %0t (10 cycle delay)", $time);
-                
-                @(posedge m_spike_valid);
-                while (m_spike_dest_id != 51) @(posedge m_spike_valid);
-                $display("  Spike to neuron 51 arrived at %0t (50 cycle delay)", $time);
-                
-                @(posedge m_spike_valid);
-                while (m_spike_dest_id != 52) @(posedge m_spike_valid);
-                $display("  Spike to neuron 52 arrived at %0t (100 cycle delay)", $time);
-            end
-        join_any
-        
+        // Delays on the wheel (MAX_DELAY = 32) arrive that many cycles
+        // late; a longer one is refused when the connection is written
+        configure_connection(40, 50, 8'd80, 1'b1, 8'd10, 16'd120);  // 10 cycle delay
+        configure_connection(40, 51, 8'd81, 1'b1, 8'd31, 16'd121);  // Longest wheel delay
+        configure_connection(40, 52, 8'd82, 1'b1, 8'd50, 16'd122);  // Past the wheel
+        configure_connection(40, 53, 8'd83, 1'b1, 8'd0, 16'd123);   // Undelayed
+        configure_neuron_base(40, 16'd120);
+        configure_neuron_count(40, 8'd4);
+        
+        expected_spikes[50] = 1; expected_weights[50] = 80;
+        expected_spikes[51] = 1; expected_weights[51] = 81;
+        expected_spikes[53] = 1; expected_weights[53] = 83;
+        
+        send_spike(40);
+        sent_time = $time;
         wait_with_timeout(200);
+        check_arrival(50, 10);
+        check_arrival(51, 31);
+        verify_results();
+        
+        // The refused connection reads back disabled and is counted
+        config_addr = {8'h00, 16'd122};
+        @(posedge clk);
+        @(posedge clk);
+        if (config_readdata[23] !== 1'b0) begin
+            $display("  ERROR: connection with delay 50 was stored enabled");
+            error_count = error_count + 1;
+        end
+        config_addr = {8'h19, 24'd0};
+        @(posedge clk);
+        @(posedge clk);
+        $display("  Connection writes refused for their delay: %0d", config_readdata);
+        if (config_readdata != 1) begin
+            $display("  ERROR: expected 1 refused connection write");
+            error_count = error_count + 1;
+        end
+        config_addr = {8'h12, 24'd0};
+        @(posedge clk);
+        @(posedge clk);
+        $display("  Spikes scheduled on the wheel: %0d", config_readdata);
+        if (config_readdata != 2) begin
+            $display("  ERROR: expected 2 spikes on the wheel");
+            error_count = error_count + 1;
+        end
         
         //---------------------------------------------------------------------
         // Test 5: FIFO Stress Test
@@ -413,7 +669,7 @@ module tb_spike_router();
         // Write configuration
         config_we = 1'b1;
         config_addr = {8'h00, 16'd200};
-        config_data = {8'd0, 1'b1, 1'b1, 8'd123, 7'd45, 2'd0, 6'd63};
+        config_data = {8'd0, 1'b1, 1'b1, 8'd123, 8'd25, 6'd63};
         @(posedge clk);
         config_we = 1'b0;
         @(posedge clk);
@@ -431,6 +687,24 @@ module tb_spike_router();
             error_count = error_count + 1;
         end
         
+        // Row bases read back: reset value n * MAX_FANOUT, then as written
+        config_addr = {8'h03, 16'd0, 8'd63};
+        @(posedge clk);
+        @(posedge clk);
+        if (config_readdata != 63 * MAX_FANOUT) begin
+            $display("  ERROR: neuron 63 reset row base %0d, expected %0d",
+                     config_readdata, 63 * MAX_FANOUT);
+            error_count = error_count + 1;
+        end
+        configure_neuron_base(63, 16'd500);
+        config_addr = {8'h03, 16'd0, 8'd63};
+        @(posedge clk);
+        @(posedge clk);
+        if (config_readdata != 500) begin
+            $display("  ERROR: neuron 63 row base reads %0d, expected 500", config_readdata);
+            error_count = error_count + 1;
+        end
+        
         // Read spike counter
         config_addr = {8'h10, 24'd0};
         @(posedge clk);
@@ -503,10 +777,11 @@ module tb_spike_router();
         @(posedge clk);
         config_we = 1'b1;
         config_addr = {8'h00, 16'd300};
-        config_data = {8'd0, 1'b0, 1'b1, 8'd99, 7'd0, 2'd0, 6'd55}; // Valid bit = 0
+        config_data = {8'd0, 1'b0, 1'b1, 8'd99, 8'd0, 6'd55}; // Valid bit = 0
         @(posedge clk);
         config_we = 1'b0;
         
+        configure_neuron_base(45, 16'd300);
         configure_neuron_count(45, 8'd1);
         
         // This spike should not generate any output
@@ -539,7 +814,7 @@ module tb_spike_router();
                 expected_spikes[i] = 1;
                 expected_weights[i] = 10 + i;
                 j = j + 1;
-            } end else begin
+            end else begin
                 expected_spikes[61] = 1;
                 expected_weights[61] = 10 + i;
             end
@@ -548,6 +823,33 @@ module tb_spike_router();
         wait_with_timeout(500);
         $display("  Generated %0d output spikes from 1 input", j);
         
+        //---------------------------------------------------------------------
+        // Test 11: Back-to-Back Fan-out Throughput
+        //---------------------------------------------------------------------
+        init_test("Back-to-Back Fan-out Throughput");
+        run_throughput(16);
+        
+        //---------------------------------------------------------------------
+        // Test 12: Overflow Policies
+        //---------------------------------------------------------------------
+        // OVERLOAD_SPIKES overrun the FIFO and held spikes by 36. Sampling
+        // keeps every spike until the FIFO holds 64, then one in four.
+        init_test("Overflow Policy: Block");
+        run_overload(2'd0, 4'd0, 16'd0, OVERLOAD_SPIKES, 0, 0, 0, FIFO_DEPTH);
+        
+        init_test("Overflow Policy: Drop Newest");
+        run_overload(2'd1, 4'd0, 16'd0, OVERLOAD_SPIKES,
+                     OVERLOAD_SPIKES - OVERLOAD_HELD - FIFO_DEPTH, 0, 0, FIFO_DEPTH);
+        
+        init_test("Overflow Policy: Drop Oldest");
+        run_overload(2'd2, 4'd0, 16'd0, OVERLOAD_SPIKES,
+                     0, OVERLOAD_SPIKES - OVERLOAD_HELD - FIFO_DEPTH, 0, FIFO_DEPTH);
+        
+        sampled = OVERLOAD_SPIKES - OVERLOAD_HELD - 64;
+        init_test("Overflow Policy: Sample 1 in 4");
+        run_overload(2'd3, 4'd2, 16'd64, OVERLOAD_SPIKES,
+                     0, 0, sampled - (sampled + 3) / 4, 64 + (sampled + 3) / 4);
+        
         //---------------------------------------------------------------------
         // Test Summary
         //---------------------------------------------------------------------
@@ -0,0 +1,321 @@
+//-----------------------------------------------------------------------------
+// Title         : Testbench for Multi-Bank Spike Router
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : tb_spike_router_banked.v
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Routes one spike burst through 1, 2 and 4 banks and
+//                 measures routed events per cycle
+//-----------------------------------------------------------------------------
+
+`timescale 1ns / 1ps
+
+module tb_spike_router_banked();
+
+    // Parameters
+    localparam NUM_NEURONS      = 64;
+    localparam MAX_FANOUT       = 8;
+    localparam WEIGHT_WIDTH     = 8;
+    localparam NEURON_ID_WIDTH  = $clog2(NUM_NEURONS);
+    localparam FIFO_DEPTH       = 64;
+    localparam NUM_CONFIGS      = 3;        // Router g has 1 << g banks
+    
+    // Burst: NUM_SOURCES neurons with FANOUT undelayed connections each,
+    // fired in turn until NUM_SPIKES spikes are sent
+    localparam NUM_SOURCES      = 16;
+    localparam FANOUT           = 8;
+    localparam NUM_SPIKES       = 64;
+    localparam NUM_EVENTS       = NUM_SPIKES * FANOUT;
+    
+    // Clock period (100MHz)
+    localparam CLK_PERIOD = 10;
+    
+    reg                         clk;
+    reg                         rst_n;
+    reg                         running;
+    
+    // Configuration interface, one address per router since the bank
+    // field and bank-local index depend on the bank count
+    reg                         config_we;
+    reg [31:0]                 config_addr [0:NUM_CONFIGS-1];
+    reg [31:0]                 config_data;
+    wire [31:0]                config_readdata [0:NUM_CONFIGS-1];
+    
+    // Per-router measurement
+    wire [NUM_CONFIGS-1:0]     in_valid;
+    wire [NUM_CONFIGS-1:0]     in_ready;
+    wire [NUM_CONFIGS-1:0]     busy;
+    integer                    sent [0:NUM_CONFIGS-1];
+    integer                    routed [0:NUM_CONFIGS-1];
+    integer                    dest_sum [0:NUM_CONFIGS-1];
+    integer                    first_cycle [0:NUM_CONFIGS-1];
+    integer                    last_cycle [0:NUM_CONFIGS-1];
+    integer                    rate_x100 [0:NUM_CONFIGS-1];
+    integer                    cycle;
+    
+    // Test variables
+    integer                    error_count;
+    integer                    expected_sum;
+    integer                    n, k, g_idx;
+    reg [NEURON_ID_WIDTH-1:0]  dest;
+    
+    // Destination of connection k of source n
+    function integer conn_dest(input integer src, input integer idx);
+        begin
+            conn_dest = (src * FANOUT + idx * 3) % NUM_NEURONS;
+        end
+    endfunction
+    
+    //-------------------------------------------------------------------------
+    // DUT Instantiation: one router per bank count, all fed the same burst
+    //-------------------------------------------------------------------------
+    genvar g;
+    generate
+        for (g = 0; g < NUM_CONFIGS; g = g + 1) begin : cfg
+            localparam BANKS = 1 << g;
+            
+            wire [BANKS-1:0]                 out_valid;
+            wire [BANKS*NEURON_ID_WIDTH-1:0] out_dest;
+            wire [NEURON_ID_WIDTH-1:0]       src_id = sent[g] % NUM_SOURCES;
+            
+            spike_router_banked #(
+                .NUM_NEURONS(NUM_NEURONS),
+                .MAX_FANOUT(MAX_FANOUT),
+                .WEIGHT_WIDTH(WEIGHT_WIDTH),
+                .NUM_BANKS(BANKS),
+                .OUT_LANES(BANKS),
+                .FIFO_DEPTH(FIFO_DEPTH)
+            ) DUT (
+                .clk(clk),
+                .rst_n(rst_n),
+                .s_spike_valid(in_valid[g]),
+                .s_spike_neuron_id(src_id),
+                .s_spike_ready(in_ready[g]),
+                .m_spike_valid(out_valid),
+                .m_spike_dest_id(out_dest),
+                .m_spike_weight(),
+                .m_spike_exc_inh(),
+                .m_spike_ready(1'b1),
+                .config_we(config_we),
+                .config_addr(config_addr[g]),
+                .config_data(config_data),
+                .config_readdata(config_readdata[g]),
+                .overflow_policy(2'd0),
+                .sample_shift(4'd0),
+                .shed_threshold(16'd0),
+                .clear_stats(1'b0),
+                .routed_spike_count(),
+                .router_busy(busy[g]),
+                .fifo_overflow(),
+                .drop_newest_count(),
+                .drop_oldest_count(),
+                .drop_sampled_count(),
+                .stall_cycles(),
+                .peak_occupancy()
+            );
+            
+            // Spikes are offered back to back while the burst runs
+            assign in_valid[g] = running && (sent[g] < NUM_SPIKES);
+            
+            // The window runs from the first accepted spike to the last
+            // routed event
+            integer lane;
+            always @(posedge clk) begin
+                if (in_valid[g] && in_ready[g]) begin
+                    if (sent[g] == 0)
+                        first_cycle[g] <= cycle;
+                    sent[g] <= sent[g] + 1;
+                end
+                for (lane = 0; lane < BANKS; lane = lane + 1) begin
+                    if (out_valid[lane]) begin
+                        routed[g] = routed[g] + 1;
+                        dest_sum[g] = dest_sum[g] + out_dest[lane*NEURON_ID_WIDTH +: NEURON_ID_WIDTH];
+                        last_cycle[g] = cycle;
+                    end
+                end
+            end
+        end
+    endgenerate
+    
+    //-------------------------------------------------------------------------
+    // Clock Generation
+    //-------------------------------------------------------------------------
+    initial begin
+        clk = 1'b0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+    
+    always @(posedge clk) begin
+        cycle <= cycle + 1;
+    end
+    
+    //-------------------------------------------------------------------------
+    // Test Tasks
+    //-------------------------------------------------------------------------
+    
+    // Write connection k of source n to every router. Connection words go
+    // to bank n % banks at row (n / banks) * MAX_FANOUT, the reset row
+    // base; the single-bank router gets a stray bank field, which it must
+    // ignore.
+    task configure_connection(
+        input integer src,
+        input integer idx,
+        input [23:0] word
+    );
+        integer c;
+        begin
+            @(posedge clk);
+            config_we = 1'b1;
+            for (c = 0; c < NUM_CONFIGS; c = c + 1) begin
+                config_addr[c] = (((c == 0) ? 1 : (src % (1 << c))) << 16) +
+                                 (src >> c) * MAX_FANOUT + idx;
+            end
+            config_data = {8'd0, word};
+            @(posedge clk);
+            config_we = 1'b0;
+        end
+    endtask
+    
+    // Set the connection count of source n (addressed by global id)
+    task configure_neuron_count(
+        input integer src,
+        input [7:0] conn_count
+    );
+        integer c;
+        begin
+            @(posedge clk);
+            config_we = 1'b1;
+            for (c = 0; c < NUM_CONFIGS; c = c + 1)
+                config_addr[c] = {8'h01, 16'd0, 8'd0} | src;
+            config_data = {24'd0, conn_count};
+            @(posedge clk);
+            config_we = 1'b0;
+        end
+    endtask
+    
+    //-------------------------------------------------------------------------
+    // Main Test Sequence
+    //-------------------------------------------------------------------------
+    initial begin
+        // Initialize signals
+        rst_n = 1'b0;
+        running = 1'b0;
+        config_we = 1'b0;
+        config_data = 0;
+        cycle = 0;
+        error_count = 0;
+        for (g_idx = 0; g_idx < NUM_CONFIGS; g_idx = g_idx + 1) begin
+            config_addr[g_idx] = 0;
+            sent[g_idx] = 0;
+            routed[g_idx] = 0;
+            dest_sum[g_idx] = 0;
+            first_cycle[g_idx] = 0;
+            last_cycle[g_idx] = 0;
+        end
+        
+        repeat(5) @(posedge clk);
+        rst_n = 1'b1;
+        @(posedge clk);
+        
+        //---------------------------------------------------------------------
+        // Test 1: Reset row bases
+        //---------------------------------------------------------------------
+        // Source n owns row n / banks of its bank, at (n / banks) * MAX_FANOUT
+        $display("\n========================================");
+        $display("Test 1: Reset row bases");
+        $display("========================================");
+        for (n = 0; n < NUM_NEURONS; n = n + 1) begin
+            for (g_idx = 0; g_idx < NUM_CONFIGS; g_idx = g_idx + 1)
+                config_addr[g_idx] = {8'h03, 16'd0, 8'd0} | n;
+            @(posedge clk);
+            for (g_idx = 0; g_idx < NUM_CONFIGS; g_idx = g_idx + 1) begin
+                if (config_readdata[g_idx] != (n >> g_idx) * MAX_FANOUT) begin
+                    $display("  ERROR: %0d bank(s), neuron %0d row base %0d, expected %0d",
+                             1 << g_idx, n, config_readdata[g_idx], (n >> g_idx) * MAX_FANOUT);
+                    error_count = error_count + 1;
+                end
+            end
+        end
+        $display("  Checked %0d neurons", NUM_NEURONS);
+        
+        //---------------------------------------------------------------------
+        // Test 2: Configure the burst network
+        //---------------------------------------------------------------------
+        $display("\n========================================");
+        $display("Test 2: Configure %0d sources x %0d connections", NUM_SOURCES, FANOUT);
+        $display("========================================");
+        for (n = 0; n < NUM_SOURCES; n = n + 1) begin
+            for (k = 0; k < FANOUT; k = k + 1) begin
+                // valid, excitatory, weight, no delay, destination
+                dest = conn_dest(n, k);
+                configure_connection(n, k, {1'b1, 1'b1, 8'd10 + k[7:0], 8'd0, dest});
+            end
+            configure_neuron_count(n, FANOUT);
+        end
+        
+        expected_sum = 0;
+        for (n = 0; n < NUM_SPIKES; n = n + 1)
+            for (k = 0; k < FANOUT; k = k + 1)
+                expected_sum = expected_sum + conn_dest(n % NUM_SOURCES, k);
+        
+        //---------------------------------------------------------------------
+        // Test 3: Back-to-back burst, events per cycle
+        //---------------------------------------------------------------------
+        $display("\n========================================");
+        $display("Test 3: %0d back-to-back spikes, %0d events", NUM_SPIKES, NUM_EVENTS);
+        $display("========================================");
+        @(negedge clk);
+        running = 1'b1;
+        while ((sent[0] < NUM_SPIKES) || (sent[1] < NUM_SPIKES) ||
+               (sent[2] < NUM_SPIKES) || (busy != 0))
+            @(posedge clk);
+        repeat(10) @(posedge clk);
+        running = 1'b0;
+        
+        for (g_idx = 0; g_idx < NUM_CONFIGS; g_idx = g_idx + 1) begin
+            rate_x100[g_idx] = (routed[g_idx] * 100) /
+                               (last_cycle[g_idx] - first_cycle[g_idx] + 1);
+            $display("  %0d bank(s): %0d events in %0d cycles, %0d.%02d events/cycle",
+                     1 << g_idx, routed[g_idx], last_cycle[g_idx] - first_cycle[g_idx] + 1,
+                     rate_x100[g_idx] / 100, rate_x100[g_idx] % 100);
+            if (routed[g_idx] != NUM_EVENTS || dest_sum[g_idx] != expected_sum) begin
+                $display("  ERROR: expected %0d events (destination sum %0d), got %0d (%0d)",
+                         NUM_EVENTS, expected_sum, routed[g_idx], dest_sum[g_idx]);
+                error_count = error_count + 1;
+            end
+            // Each bank fans out one event per cycle once its pipeline fills
+            if (rate_x100[g_idx] < 90 * (1 << g_idx)) begin
+                $display("  ERROR: %0d bank(s) should route close to %0d events/cycle",
+                         1 << g_idx, 1 << g_idx);
+                error_count = error_count + 1;
+            end
+        end
+        
+        //---------------------------------------------------------------------
+        // Test Summary
+        //---------------------------------------------------------------------
+        $display("\n========================================");
+        $display("Test Summary");
+        $display("========================================");
+        $display("Total Errors: %0d", error_count);
+        
+        if (error_count == 0) begin
+            $display("\nAll tests PASSED!");
+        end else begin
+            $display("\nTests FAILED with %0d errors!", error_count);
+        end
+        
+        $display("========================================\n");
+        $finish;
+    end
+    
+    //-------------------------------------------------------------------------
+    // Timeout Watchdog
+    //-------------------------------------------------------------------------
+    initial begin
+        #200_000;
+        $display("\n*** ERROR: Testbench timeout! ***");
+        $finish;
+    end
+
+endmodule
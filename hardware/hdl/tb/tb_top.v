@@ -31,6 +31,7 @@ module tb_top();
     localparam ADDR_THRESHOLD   = 32'h00000014;
     localparam ADDR_REFRAC      = 32'h00000018;
     localparam ADDR_VERSION     = 32'h0000001C;
+    localparam ADDR_COMMIT      = 32'h00000054;
     
     //-------------------------------------------------------------------------
     // DUT Signals
@@ -72,6 +73,35 @@ module tb_top();
     reg                             m_axis_tready;
     wire                            m_axis_tlast;
     
+    // AXI4-Stream slave (bulk table load)
+    reg [31:0]                      s_axis_load_tdata;
+    reg                             s_axis_load_tvalid;
+    wire                            s_axis_load_tready;
+    reg                             s_axis_load_tlast;
+    
+    // AXI4-Stream master (state snapshot)
+    wire [31:0]                     m_axis_state_tdata;
+    wire                            m_axis_state_tvalid;
+    reg                             m_axis_state_tready;
+    wire                            m_axis_state_tlast;
+    
+    // Weight paging streams (unused with WEIGHT_PAGING = 0)
+    wire [71:0]                     m_axis_page_cmd_tdata;
+    wire                            m_axis_page_cmd_tvalid;
+    reg                             m_axis_page_cmd_tready;
+    reg [31:0]                      s_axis_page_tdata;
+    reg                             s_axis_page_tvalid;
+    wire                            s_axis_page_tready;
+    reg                             s_axis_page_tlast;
+    reg [31:0]                      s_axis_aer_tdata;
+    reg                             s_axis_aer_tvalid;
+    wire                            s_axis_aer_tready;
+    reg                             s_axis_aer_tlast;
+    wire [31:0]                     m_axis_aer_tdata;
+    wire                            m_axis_aer_tvalid;
+    reg                             m_axis_aer_tready;
+    wire                            m_axis_aer_tlast;
+    
     // Other signals
     wire                            interrupt;
     wire [3:0]                      led;
@@ -132,6 +162,29 @@ module tb_top();
         .m_axis_tvalid(m_axis_tvalid),
         .m_axis_tready(m_axis_tready),
         .m_axis_tlast(m_axis_tlast),
+        .s_axis_load_tdata(s_axis_load_tdata),
+        .s_axis_load_tvalid(s_axis_load_tvalid),
+        .s_axis_load_tready(s_axis_load_tready),
+        .s_axis_load_tlast(s_axis_load_tlast),
+        .m_axis_state_tdata(m_axis_state_tdata),
+        .m_axis_state_tvalid(m_axis_state_tvalid),
+        .m_axis_state_tready(m_axis_state_tready),
+        .m_axis_state_tlast(m_axis_state_tlast),
+        .m_axis_page_cmd_tdata(m_axis_page_cmd_tdata),
+        .m_axis_page_cmd_tvalid(m_axis_page_cmd_tvalid),
+        .m_axis_page_cmd_tready(m_axis_page_cmd_tready),
+        .s_axis_page_tdata(s_axis_page_tdata),
+        .s_axis_page_tvalid(s_axis_page_tvalid),
+        .s_axis_page_tready(s_axis_page_tready),
+        .s_axis_page_tlast(s_axis_page_tlast),
+        .s_axis_aer_tdata(s_axis_aer_tdata),
+        .s_axis_aer_tvalid(s_axis_aer_tvalid),
+        .s_axis_aer_tready(s_axis_aer_tready),
+        .s_axis_aer_tlast(s_axis_aer_tlast),
+        .m_axis_aer_tdata(m_axis_aer_tdata),
+        .m_axis_aer_tvalid(m_axis_aer_tvalid),
+        .m_axis_aer_tready(m_axis_aer_tready),
+        .m_axis_aer_tlast(m_axis_aer_tlast),
         
         // Other I/O
         .interrupt(interrupt),
@@ -324,6 +377,18 @@ module tb_top();
         s_axis_tdata = 0;
         s_axis_tvalid = 0;
         s_axis_tlast = 0;
+        s_axis_load_tdata = 0;
+        s_axis_load_tvalid = 0;
+        s_axis_load_tlast = 0;
+        m_axis_state_tready = 1;
+        m_axis_page_cmd_tready = 1;
+        s_axis_page_tdata = 0;
+        s_axis_page_tvalid = 0;
+        s_axis_page_tlast = 0;
+        s_axis_aer_tdata = 0;
+        s_axis_aer_tvalid = 0;
+        s_axis_aer_tlast = 0;
+        m_axis_aer_tready = 1;
         m_axis_tready = 1;
         sw = 2'b00;
         btn = 4'b0000;
@@ -357,18 +422,44 @@ module tb_top();
             error_count = error_count + 1;
         end
         
-        // Configure neuron parameters
+        // Configure neuron parameters: shadow writes, applied together by
+        // COMMIT, which lands at once while the core is disabled
+        axi_write(ADDR_CTRL, 32'h00000000);
         axi_write(ADDR_LEAK_RATE, 32'h0000000A);    // Leak rate = 10
         axi_write(ADDR_THRESHOLD, 32'h000003E8);    // Threshold = 1000
         axi_write(ADDR_REFRAC, 32'h00000014);       // Refractory = 20
+        axi_write(ADDR_COMMIT, 32'h00000001);
+        axi_write(ADDR_CTRL, 32'h00000001);
         
-        // Read back parameters
+        // Read back parameters: live value in [31:16], shadow in [15:0]
         axi_read(ADDR_LEAK_RATE, read_data);
-        $display("  Leak rate: %0d", read_data[15:0]);
+        $display("  Leak rate: %0d", read_data[31:16]);
+        if (read_data[31:16] != 16'd10) error_count = error_count + 1;
         axi_read(ADDR_THRESHOLD, read_data);
-        $display("  Threshold: %0d", read_data[15:0]);
+        $display("  Threshold: %0d", read_data[31:16]);
+        if (read_data[31:16] != 16'd1000) error_count = error_count + 1;
         axi_read(ADDR_REFRAC, read_data);
-        $display("  Refractory period: %0d", read_data[15:0]);
+        $display("  Refractory period: %0d", read_data[31:16]);
+        if (read_data[31:16] != 16'd20) error_count = error_count + 1;
+        axi_read(ADDR_COMMIT, read_data);
+        if (read_data[0] == 1'b0 && read_data[31:16] == 16'd1) begin
+            $display("  PASS: Neuron parameters committed");
+        end else begin
+            $display("  ERROR: Parameter commit still pending");
+            error_count = error_count + 1;
+        end
+        
+        // A weight write whose low byte matches a register must not touch it
+        axi_write(ADDR_CONFIG, 32'h00000100);
+        axi_write(32'h00001000 | ADDR_LEAK_RATE, 32'h00000000);
+        axi_write(ADDR_CONFIG, 32'h00000000);
+        axi_read(ADDR_LEAK_RATE, read_data);
+        if (read_data[15:0] == 16'd10) begin
+            $display("  PASS: Weight region does not alias registers");
+        end else begin
+            $display("  ERROR: Weight write landed in leak rate (0x%04x)", read_data[15:0]);
+            error_count = error_count + 1;
+        end
         
         //---------------------------------------------------------------------
         // Test 2: Status Register Check
@@ -601,12 +692,13 @@ module tb_top();
         // Reset everything
         axi_write(ADDR_CTRL, 32'h00000002);
         #(CLK_PERIOD * 10);
-        axi_write(ADDR_CTRL, 32'h00000001);
         
-        // Configure realistic SNN parameters
+        // Configure realistic SNN parameters, committed before re-enabling
         axi_write(ADDR_LEAK_RATE, 32'h00000008);
         axi_write(ADDR_THRESHOLD, 32'h00000320);  // 800
         axi_write(ADDR_REFRAC, 32'h00000019);     // 25
+        axi_write(ADDR_COMMIT, 32'h00000001);
+        axi_write(ADDR_CTRL, 32'h00000001);
         
         // Create a small fully connected layer (4x4)
         $display("  Creating 4x4 fully connected network...");
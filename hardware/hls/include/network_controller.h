@@ -11,6 +11,9 @@
 #define NETWORK_CONTROLLER_H
 
 #include "snn_types.h"
+#include "sh_utils.h"
+#include "spike_encoder.h"
+#include "spike_decoder.h"
 
 // Network commands
 enum network_command_t {
@@ -19,7 +22,9 @@ enum network_command_t {
     CMD_STOP = 2,
     CMD_PAUSE = 3,
     CMD_RESUME = 4,
-    CMD_RESET = 5
+    CMD_RESET = 5,
+    CMD_RUN_RING = 6,       // Drain the job ring, then return (one ap_done per batch)
+    CMD_STORE_CONTEXT = 7   // Copy the context argument into bank slot context_id
 };
 
 // Network states
@@ -44,6 +49,19 @@ struct network_config_t {
     bool enable_monitoring;
 };
 
+// Stored network context: everything that differs between the models served
+// from one board. Contexts live in an on-chip bank, so switching models is a
+// bank lookup whose result travels with each frame instead of a full
+// parameter reload.
+const int MAX_CONTEXTS = 4;
+
+struct network_context_t {
+    network_config_t network;
+    encoder_config_t encoder;
+    decoder_config_t decoder;
+    ap_uint<32> weight_base;        // First weight beat of this model in weight memory
+};
+
 // Network status
 struct network_status_t {
     network_state_t state;
@@ -51,6 +69,49 @@ struct network_status_t {
     ap_uint<32> batches_processed;
     ap_uint<16> errors;
     ap_uint<16> warnings;
+    ap_uint<8>  context_id;         // Context of the most recently issued job
+    ap_uint<MAX_CONTEXTS> contexts_valid;
+    performance_counter_t perf;     // Controller activity and stream stalls
+};
+
+// Job descriptor ring: the host fills entries and advances ring_tail, the
+// controller consumes from its own head and writes one completion per entry.
+// Addresses are element indices into the frame/result buffers.
+const int JOBS_IN_FLIGHT = 2;       // Frames issued ahead of their results
+
+struct job_descriptor_t {
+    ap_uint<32> job_id;             // Host tag, echoed in the completion
+    ap_uint<32> input_addr;         // Index into frame_memory
+    ap_uint<32> output_addr;        // Index into result_memory
+    ap_uint<16> timesteps;          // Encoder timesteps for this frame
+    ap_uint<8>  mode;               // network_mode_t
+    ap_uint<8>  context_id;         // Stored context this job runs under
+};
+
+// Per-frame control issued with every ring frame on frame_ctrl. snn_pipeline
+// reads one per frame (frame_ctrl_en), so each job's timestep count, mode and
+// context reach every stage of the datapath along with its pixels.
+struct frame_control_t {
+    spike_time_t start_time;        // Global timestep of the frame's first step
+    ap_uint<16> timesteps;          // Timesteps this frame runs for
+    ap_uint<8>  mode;               // network_mode_t
+    ap_uint<8>  context_id;         // Context the frame runs under
+    ap_uint<32> weight_base;        // Context's first weight beat
+    encoder_config_t encoder;       // Context's encoder parameters
+    decoder_config_t decoder;       // Context's decoder parameters
+};
+
+// Completion status codes
+const int JOB_STATUS_DONE = 0;
+const int JOB_STATUS_BAD_CONTEXT = 1;   // context_id names an empty bank slot
+
+struct job_completion_t {
+    ap_uint<32> job_id;
+    ap_uint<32> frame_id;
+    ap_uint<8>  class_id;
+    ap_uint<8>  confidence;
+    ap_uint<16> status;             // JOB_STATUS_*
+    ap_uint<32> reserved;
 };
 
 // Function prototype
@@ -59,17 +120,50 @@ void network_controller(
     network_config_t config,
     hls::stream<input_data_t> &input_data,
     hls::stream<output_data_t> &output_data,
+    hls::stream<input_data_t> &encoder_data,
+    hls::stream<frame_control_t> &frame_ctrl,
     hls::stream<control_packet_t> &encoder_ctrl,
     hls::stream<control_packet_t> &learning_ctrl,
     hls::stream<control_packet_t> &decoder_ctrl,
+    hls::stream<output_data_t> &decoder_results,
+    network_context_t context,
+    ap_uint<8> context_id,
+    const job_descriptor_t *job_ring,
+    const input_data_t *frame_memory,
+    output_data_t *result_memory,
+    job_completion_t *completions,
+    ap_uint<16> ring_size,
+    ap_uint<16> ring_tail,
+    ap_uint<16> &ring_head,
+    spike_time_t &timestep,
     network_status_t &status
 );
 
+bool process_job_ring(
+    const job_descriptor_t *job_ring,
+    const input_data_t *frame_memory,
+    output_data_t *result_memory,
+    job_completion_t *completions,
+    ap_uint<16> ring_size,
+    ap_uint<16> ring_tail,
+    ap_uint<16> &head,
+    const network_context_t context_bank[MAX_CONTEXTS],
+    ap_uint<MAX_CONTEXTS> contexts_valid,
+    ap_uint<8> &active_id,
+    hls::stream<input_data_t> &encoder_data,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<output_data_t> &decoder_results,
+    spike_time_t &global_time,
+    ap_uint<32> &jobs_done,
+    performance_counter_t &perf
+);
+
 // Helper functions
 void send_control_packet(
     hls::stream<control_packet_t> &stream,
     control_command_t cmd,
-    ap_uint<16> param
+    ap_uint<16> param,
+    spike_time_t timestamp
 );
 
 #endif // NETWORK_CONTROLLER_H
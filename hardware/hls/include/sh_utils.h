@@ -67,12 +67,16 @@ struct performance_counter_t {
     ap_uint<32> cycles;
     ap_uint<32> operations;
     ap_uint<32> stalls;
+    ap_uint<32> empty_stalls;   // Waits (or empty polls) on an input stream
+    ap_uint<32> full_stalls;    // Waits (or full writes) on an output stream
     
     void reset() {
         #pragma HLS INLINE
         cycles = 0;
         operations = 0;
         stalls = 0;
+        empty_stalls = 0;
+        full_stalls = 0;
     }
     
     void update(bool active, bool stalled) {
@@ -82,6 +86,15 @@ struct performance_counter_t {
         if (stalled) stalls++;
     }
     
+    void update(bool active, bool input_empty, bool output_full) {
+        #pragma HLS INLINE
+        cycles++;
+        if (active) operations++;
+        if (input_empty || output_full) stalls++;
+        if (input_empty) empty_stalls++;
+        if (output_full) full_stalls++;
+    }
+    
     ap_uint<8> get_efficiency() {
         #pragma HLS INLINE
         if (cycles == 0) return 0;
@@ -89,6 +102,74 @@ struct performance_counter_t {
     }
 };
 
+// Blocking stream accesses that count the cycles spent waiting
+template<typename T>
+T counted_read(hls::stream<T> &stream, performance_counter_t &perf) {
+    #pragma HLS INLINE
+    T value;
+    READ_WAIT: while (!stream.read_nb(value)) {
+        perf.update(false, true, false);
+    }
+    return value;
+}
+
+template<typename T>
+void counted_write(hls::stream<T> &stream, const T &value, performance_counter_t &perf) {
+    #pragma HLS INLINE
+    WRITE_WAIT: while (!stream.write_nb(value)) {
+        perf.update(false, false, true);
+    }
+}
+
+// Single-attempt accesses for per-call kernels and II=1 loops, where a wait
+// loop cannot sit. Each poll counts as one operation or one empty stall; a
+// write that finds the output full counts one full stall, then blocks.
+template<typename T>
+bool counted_read_nb(hls::stream<T> &stream, T &value, performance_counter_t &perf) {
+    #pragma HLS INLINE
+    bool got = stream.read_nb(value);
+    perf.update(got, !got, false);
+    return got;
+}
+
+template<typename T>
+void counted_write_once(hls::stream<T> &stream, const T &value, performance_counter_t &perf) {
+    #pragma HLS INLINE
+    if (stream.full()) {
+        perf.update(false, false, true);
+    }
+    stream.write(value);
+}
+
+// Shadow (double-buffered) configuration. The s_axilite config port is the
+// shadow copy: the host may rewrite it at any time, then bumps commit_seq.
+// The kernel keeps running on the active copy and adopts the shadow at its
+// next frame boundary, so no frame sees a half-written parameter set.
+template<typename T>
+struct shadow_config_t {
+    T active;
+    ap_uint<8> seq;         // commit_seq the active copy was taken at
+    bool loaded;
+    
+    // Returns true when the shadow copy was committed on this call
+    bool commit(const T &shadow, ap_uint<8> commit_seq, bool boundary) {
+        #pragma HLS INLINE
+        if (!loaded || (boundary && commit_seq != seq)) {
+            active = shadow;
+            seq = commit_seq;
+            loaded = true;
+            return true;
+        }
+        return false;
+    }
+    
+    // Next commit() loads the shadow unconditionally
+    void reset() {
+        #pragma HLS INLINE
+        loaded = false;
+    }
+};
+
 // Circular buffer for spike history
 template<int SIZE>
 class SpikeHistory {
@@ -113,7 +194,7 @@ public:
     
     bool find_recent(neuron_id_t id, spike_time_t &time, spike_time_t window) {
         #pragma HLS INLINE
-        for (int i = 0; i < MIN(count, SIZE); i++) {
+        for (int i = 0; i < MIN(count, ap_uint<16>(SIZE)); i++) {
             #pragma HLS UNROLL factor=4
             int idx = (write_ptr - 1 - i + SIZE) % SIZE;
             if (buffer[idx].neuron_id == id && 
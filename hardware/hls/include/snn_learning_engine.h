@@ -11,6 +11,7 @@
 #define SNN_LEARNING_ENGINE_H
 
 #include "snn_types.h"
+#include "sh_utils.h"
 
 // Learning configuration structure
 struct learning_config_t {
@@ -23,15 +24,36 @@ struct learning_config_t {
     ap_fixed<16,8> target_rate;   // Target firing rate for homeostasis
 };
 
+// Checkpoint commands: SAVE bursts the STDP state to checkpoint_memory,
+// RESTORE bursts it back, so a learning job can be preempted and resumed
+enum checkpoint_command_t {
+    CKPT_NONE = 0,
+    CKPT_SAVE = 1,
+    CKPT_RESTORE = 2
+};
+
+// Checkpoint layout in checkpoint_memory (32-bit words)
+const int CKPT_PRE_TIMES = 0;                   // pre_spike_times[MAX_NEURONS]
+const int CKPT_POST_TIMES = MAX_NEURONS;        // post_spike_times[MAX_NEURONS]
+const int CKPT_UPDATE_COUNT = 2 * MAX_NEURONS;  // Updates issued so far
+const int CKPT_HELD = 2 * MAX_NEURONS + 1;      // Held flags, then held pre and post spikes
+const int CKPT_WORDS = CKPT_HELD + 7;
+
 // Function prototypes
 void snn_learning_engine(
     bool enable,
     bool reset,
-    learning_config_t config,
+    spike_time_t timestep,
+    learning_config_t shadow_config,
+    ap_uint<8> commit_seq,
     hls::stream<spike_event_t> &pre_spikes,
     hls::stream<spike_event_t> &post_spikes,
     hls::stream<weight_update_t> &weight_updates,
-    ap_uint<32> &status
+    checkpoint_command_t checkpoint,
+    ap_uint<32> *checkpoint_memory,
+    ap_uint<32> &status,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 );
 
 weight_delta_t calculate_ltp(ap_int<32> dt, learning_config_t config);
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+// Title         : SNN Pipeline Header
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : snn_pipeline.h
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Fused frame pipeline (dispatch -> encoder -> LIF core ->
+//                 learning / decoder) as a single DATAFLOW kernel
+//-----------------------------------------------------------------------------
+
+#ifndef SNN_PIPELINE_H
+#define SNN_PIPELINE_H
+
+#include "snn_types.h"
+#include "network_controller.h"
+#include "spike_encoder.h"
+#include "spike_decoder.h"
+#include "snn_learning_engine.h"
+#include "weight_updater.h"
+
+// End-of-timestep marker on inter-stage spike streams. The pipeline encodes
+// at most MAX_NEURONS channels, so this id never names a real neuron.
+const neuron_id_t SPIKE_STEP_END = 0xFF;
+
+// Inter-stage FIFO depths
+const int SPIKE_FIFO_DEPTH = 128;   // One full timestep of spikes plus marker
+const int FRAME_FIFO_DEPTH = 4;     // Frames in flight between controller and decoder
+
+// Membrane potential inside the neuron core
+typedef ap_int<20> potential_t;
+const int POTENTIAL_MAX = (1 << 19) - 1;
+const int POTENTIAL_MIN = -(1 << 19);
+
+// Neuron core configuration
+struct core_config_t {
+    ap_uint<16> threshold;          // Firing threshold
+    ap_uint<16> leak_rate;          // Decay toward rest per timestep
+    ap_uint<8>  refractory_period;  // Timesteps held at rest after a spike
+};
+
+// Extended status block: one counter set per stage, written once at the end
+// of every run so the host collects it in a single burst
+struct pipeline_status_t {
+    performance_counter_t dispatch;
+    performance_counter_t encoder;
+    performance_counter_t core;
+    performance_counter_t learning;
+    performance_counter_t decoder;
+};
+
+// The pipeline is a separate kernel, not a wrapper around network_controller,
+// spike_encoder, snn_learning_engine and spike_decoder. Those are
+// per-timestep kernels with static state, and the controller waits on the
+// decoder's results, a feedback path a DATAFLOW region cannot express. The
+// stages here reuse the kernels' encode_*, calculate_ltp/ltd, decode_* and
+// decay helpers, with frame-level loops of their own. The configuration
+// arguments are latched when a run starts, so every frame of a batch sees
+// one parameter set without the kernels' shadow commit.
+//
+// Top-level pipeline. Processes config.batch_size frames. By default each
+// frame runs for enc_config.time_window timesteps in config.mode, the first
+// starting at global timestep start_time, with weights from beat weight_base
+// and the enc_config/dec_config parameters. With frame_ctrl_en set, every
+// frame instead takes all of these from the frame_control_t that
+// network_controller issues with it on frame_ctrl (one per ring job, carrying
+// the job's stored context); the host sets batch_size to the number of jobs
+// queued. Weights are read from the packed dense weight_updater layout at the
+// start of every frame, so updates issued on weight_updates take effect on
+// later frames. Decay the updater still owes a row (row_epoch, weight_config)
+// is applied on that load; row scales and decay epochs are shared by every
+// context.
+void snn_pipeline(
+    network_config_t config,
+    encoder_config_t enc_config,
+    core_config_t core_config,
+    learning_config_t learn_config,
+    decoder_config_t dec_config,
+    spike_time_t start_time,
+    hls::stream<input_data_t> &input_data,
+    bool frame_ctrl_en,
+    hls::stream<frame_control_t> &frame_ctrl,
+    const weight_beat_t *weight_memory,
+    ap_uint<32> weight_base,
+    const weight_scale_t row_scale[MAX_NEURONS],
+    const decay_epoch_t *row_epoch,
+    weight_config_t weight_config,
+    hls::stream<output_data_t> &output_data,
+    hls::stream<weight_update_t> &weight_updates,
+    ap_uint<32> &frames_done,
+    ap_uint<32> &spikes_encoded,
+    ap_uint<32> &spikes_fired,
+    ap_uint<32> &updates_issued,
+    pipeline_status_t *status_block
+);
+
+// Pipeline stages. Dispatch hands every later stage its own copy of each
+// frame's control.
+void dispatch_frames(
+    ap_uint<16> num_frames,
+    ap_uint<8> mode,
+    encoder_config_t enc_config,
+    decoder_config_t dec_config,
+    ap_uint<32> weight_base,
+    spike_time_t start_time,
+    bool frame_ctrl_en,
+    hls::stream<input_data_t> &input_data,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<input_data_t> &frames,
+    hls::stream<frame_control_t> &encoder_ctrl,
+    hls::stream<frame_control_t> &core_ctrl,
+    hls::stream<frame_control_t> &learning_ctrl,
+    hls::stream<frame_control_t> &decoder_ctrl,
+    hls::stream<ap_uint<32> > &frame_ids,
+    hls::stream<performance_counter_t> &perf_out
+);
+
+void encode_frames(
+    ap_uint<16> num_frames,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<input_data_t> &frames,
+    hls::stream<spike_event_t> &spikes_out,
+    ap_uint<32> &spike_count,
+    hls::stream<performance_counter_t> &perf_out
+);
+
+void neuron_core(
+    ap_uint<16> num_frames,
+    core_config_t config,
+    hls::stream<frame_control_t> &frame_ctrl,
+    const weight_beat_t *weight_memory,
+    const weight_scale_t row_scale[MAX_NEURONS],
+    const decay_epoch_t *row_epoch,
+    weight_config_t weight_config,
+    hls::stream<spike_event_t> &spikes_in,
+    hls::stream<spike_event_t> &pre_spikes,
+    hls::stream<spike_event_t> &post_spikes,
+    hls::stream<spike_event_t> &spikes_out,
+    ap_uint<32> &spike_count,
+    hls::stream<performance_counter_t> &perf_out
+);
+
+void learn_frames(
+    ap_uint<16> num_frames,
+    learning_config_t config,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<spike_event_t> &pre_spikes,
+    hls::stream<spike_event_t> &post_spikes,
+    hls::stream<weight_update_t> &weight_updates,
+    ap_uint<32> &update_count,
+    hls::stream<performance_counter_t> &perf_out
+);
+
+void decode_frames(
+    ap_uint<16> num_frames,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<spike_event_t> &spikes_in,
+    hls::stream<ap_uint<32> > &frame_ids,
+    hls::stream<output_data_t> &data_out,
+    ap_uint<32> &frame_count,
+    hls::stream<performance_counter_t> &perf_out
+);
+
+void report_status(
+    hls::stream<performance_counter_t> &dispatch_perf,
+    hls::stream<performance_counter_t> &encoder_perf,
+    hls::stream<performance_counter_t> &core_perf,
+    hls::stream<performance_counter_t> &learning_perf,
+    hls::stream<performance_counter_t> &decoder_perf,
+    pipeline_status_t *status_block
+);
+
+#endif // SNN_PIPELINE_H
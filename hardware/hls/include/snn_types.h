@@ -19,16 +19,43 @@ const int MAX_NEURONS = 64;
 const int MAX_SYNAPSES = 4096;  // 64x64
 const int MAX_INPUT_CHANNELS = 784;  // For MNIST 28x28
 const int MAX_OUTPUT_NEURONS = 10;   // For 10 classes
+const int MAX_SPIKES_PER_STEP = 256; // Spike events a module drains per global timestep
 
 // Basic data types
 typedef ap_uint<8> neuron_id_t;
 typedef ap_uint<8> axon_id_t;
-typedef ap_uint<32> spike_time_t;
+typedef ap_uint<32> spike_time_t;  // Global timestep, driven by network_controller
 typedef ap_int<8> weight_t;
 typedef ap_int<16> weight_delta_t;
 typedef ap_uint<8> pixel_t;
 typedef ap_uint<16> membrane_t;
 
+// Stored weight precision (select with -DWEIGHT_PRECISION=...)
+#define WEIGHT_PRECISION_INT8    0
+#define WEIGHT_PRECISION_INT4    1
+#define WEIGHT_PRECISION_TERNARY 2
+
+#ifndef WEIGHT_PRECISION
+#define WEIGHT_PRECISION WEIGHT_PRECISION_INT8
+#endif
+
+#if WEIGHT_PRECISION == WEIGHT_PRECISION_TERNARY
+const int WEIGHT_CODE_BITS = 2;     // {-1, 0, +1} x row scale
+const int WEIGHT_CODE_MAX = 1;
+const int WEIGHT_CODE_MIN = -1;
+#elif WEIGHT_PRECISION == WEIGHT_PRECISION_INT4
+const int WEIGHT_CODE_BITS = 4;     // [-8, 7] x row scale
+const int WEIGHT_CODE_MAX = 7;
+const int WEIGHT_CODE_MIN = -8;
+#else
+const int WEIGHT_CODE_BITS = 8;     // Full-precision weights, row scale unused
+const int WEIGHT_CODE_MAX = 127;
+const int WEIGHT_CODE_MIN = -128;
+#endif
+
+typedef ap_int<WEIGHT_CODE_BITS> weight_code_t;   // Stored weight code
+typedef ap_uint<3> weight_scale_t;                // Per-row scale as a left shift
+
 // Fixed-point types for learning
 typedef ap_fixed<16,8> learning_rate_t;
 typedef ap_fixed<16,8> decay_rate_t;
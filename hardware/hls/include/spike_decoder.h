@@ -11,6 +11,7 @@
 #define SPIKE_DECODER_H
 
 #include "snn_types.h"
+#include "sh_utils.h"
 
 // Decoder configuration
 struct decoder_config_t {
@@ -25,10 +26,14 @@ struct decoder_config_t {
 // Function prototypes
 void spike_decoder(
     bool enable,
-    decoder_config_t config,
+    spike_time_t timestep,
+    decoder_config_t shadow_config,
+    ap_uint<8> commit_seq,
     hls::stream<spike_event_t> &spikes_in,
     hls::stream<output_data_t> &data_out,
-    ap_uint<32> &status
+    ap_uint<32> &status,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 );
 
 // Decoding functions
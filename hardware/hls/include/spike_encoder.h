@@ -11,6 +11,7 @@
 #define SPIKE_ENCODER_H
 
 #include "snn_types.h"
+#include "sh_utils.h"
 
 // Encoder configuration
 struct encoder_config_t {
@@ -26,10 +27,14 @@ struct encoder_config_t {
 // Function prototypes
 void spike_encoder(
     bool enable,
-    encoder_config_t config,
+    spike_time_t timestep,
+    encoder_config_t shadow_config,
+    ap_uint<8> commit_seq,
     hls::stream<input_data_t> &data_in,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_count
+    ap_uint<32> &spike_count,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 );
 
 // Encoding functions
@@ -39,7 +44,8 @@ void encode_rate(
     ap_uint<32> time,
     encoder_config_t config,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_counter
+    ap_uint<32> &spike_counter,
+    performance_counter_t &perf
 );
 
 void encode_temporal(
@@ -48,7 +54,8 @@ void encode_temporal(
     ap_uint<32> time,
     encoder_config_t config,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_counter
+    ap_uint<32> &spike_counter,
+    performance_counter_t &perf
 );
 
 void encode_phase(
@@ -58,7 +65,8 @@ void encode_phase(
     encoder_config_t config,
     ap_uint<16> &phase_acc,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_counter
+    ap_uint<32> &spike_counter,
+    performance_counter_t &perf
 );
 
 // Utility functions
@@ -11,13 +11,53 @@
 #define WEIGHT_UPDATER_H
 
 #include "snn_types.h"
+#include "sh_utils.h"
+
+// Lazy decay parameters
+const int DECAY_FRAC_BITS = 16;         // Retention factors are Q0.16 (1.0 = 1 << 16)
+const int DECAY_POW_BITS = 16;          // Power table covers up to 2^16 - 1 elapsed epochs
+const int MAX_OWED_EPOCHS = (1 << DECAY_POW_BITS) - 1;
+
+typedef ap_uint<DECAY_FRAC_BITS + 1> decay_factor_t;
+typedef ap_uint<32> decay_epoch_t;      // Global timestep >> decay_epoch_shift
+typedef ap_uint<DECAY_POW_BITS> decay_elapsed_t;
+
+// Packed weight memory layout: weight code i lives in beat i / WEIGHTS_PER_BEAT,
+// lane i % WEIGHTS_PER_BEAT (little-endian, so a host int8 matrix maps onto
+// the packed beats byte for byte in full-precision mode)
+#ifndef WEIGHT_BEAT_BITS
+#define WEIGHT_BEAT_BITS 64             // Zynq-7000 HP port width (128 for wider fabrics)
+#endif
+
+const int WEIGHTS_PER_BEAT = WEIGHT_BEAT_BITS / WEIGHT_CODE_BITS;
+const int BEATS_PER_ROW = MAX_NEURONS / WEIGHTS_PER_BEAT;
+const int WEIGHT_BEATS = MAX_SYNAPSES / WEIGHTS_PER_BEAT;
+
+typedef ap_uint<WEIGHT_BEAT_BITS> weight_beat_t;
+
+// Sparse (CSR) synapse store: entries row_ptr[pre] .. row_ptr[pre + 1] - 1
+// hold the post ids (ascending) in col_idx and the weight codes in the
+// packed weight memory, so storage scales with the synapse count
+typedef ap_uint<16> csr_ptr_t;
+
+// Dirty-row readback record: one packed beat of a row touched since the last readback
+struct weight_row_beat_t {
+    neuron_id_t row;            // Row (pre-synaptic neuron) id
+    ap_uint<16> beat;           // Beat index in weight memory
+    weight_beat_t data;         // Packed weight codes
+    bool last;                  // Final beat of this row
+};
+
+typedef ap_uint<MAX_NEURONS> dirty_bitmap_t;
 
 // Weight configuration
 struct weight_config_t {
     weight_t max_weight;
     weight_t min_weight;
     bool enable_decay;
-    ap_uint<8> decay_rate;      // Decay rate (0-255, where 255 = no decay)
+    ap_uint<8> decay_rate;      // Retention per epoch, (rate + 1)/256 (255 = no decay)
+    ap_uint<5> decay_epoch_shift; // Decay epoch = update timestamp >> shift
+    bool sparse;                 // CSR layout (row_ptr/col_idx) instead of dense pre x post
     bool enable_normalization;   // Enable synaptic normalization
     ap_uint<16> norm_target;     // Target sum of weights
 };
@@ -26,14 +66,108 @@ struct weight_config_t {
 void weight_updater(
     bool enable,
     bool reset,
+    bool clear_dirty,
+    bool stream_dirty,
+    spike_time_t global_time,
     hls::stream<weight_update_t> &updates_in,
-    weight_t *weight_memory,
-    weight_config_t config,
-    ap_uint<32> &updates_applied
+    weight_beat_t *weight_memory,
+    decay_epoch_t *row_epoch,
+    const csr_ptr_t *row_ptr,
+    const neuron_id_t *col_idx,
+    const weight_scale_t row_scale[MAX_NEURONS],
+    weight_config_t shadow_config,
+    ap_uint<8> commit_seq,
+    hls::stream<weight_row_beat_t> &dirty_out,
+    ap_uint<32> &updates_applied,
+    dirty_bitmap_t &dirty_bitmap,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 );
 
 // Utility functions
-weight_t apply_decay(weight_t weight, ap_uint<8> decay_rate);
+weight_code_t apply_decay(weight_code_t code, decay_factor_t factor);
+ap_int<16> quantize_delta(weight_delta_t delta, weight_scale_t shift, ap_uint<16> &lfsr);
+void build_decay_table(ap_uint<8> decay_rate, decay_factor_t table[DECAY_POW_BITS]);
+decay_factor_t decay_factor(decay_elapsed_t elapsed, const decay_factor_t table[DECAY_POW_BITS]);
+void decay_row(weight_beat_t *weight_memory, ap_uint<32> first, ap_uint<32> last, decay_factor_t factor);
+void stream_dirty_rows(const weight_beat_t *weight_memory, const csr_ptr_t *row_ptr,
+                       bool sparse, dirty_bitmap_t dirty,
+                       hls::stream<weight_row_beat_t> &dirty_out,
+                       performance_counter_t &perf);
+bool find_synapse(const neuron_id_t *col_idx, csr_ptr_t row_begin, csr_ptr_t row_end,
+                  neuron_id_t post, csr_ptr_t &slot);
+
+// Epochs a row has sat undecayed, saturated at the power table's range
+inline decay_elapsed_t owed_epochs(decay_epoch_t now, decay_epoch_t last) {
+    #pragma HLS INLINE
+    if (now <= last) return 0;
+    decay_epoch_t elapsed = now - last;
+    if (elapsed > MAX_OWED_EPOCHS) return MAX_OWED_EPOCHS;
+    return elapsed;
+}
+
+// Lane access to a packed weight beat
+inline weight_code_t weight_lane_get(weight_beat_t beat, int lane) {
+    #pragma HLS INLINE
+    return beat.range(lane * WEIGHT_CODE_BITS + WEIGHT_CODE_BITS - 1, lane * WEIGHT_CODE_BITS);
+}
+
+inline weight_beat_t weight_lane_set(weight_beat_t beat, int lane, weight_code_t code) {
+    #pragma HLS INLINE
+    beat.range(lane * WEIGHT_CODE_BITS + WEIGHT_CODE_BITS - 1, lane * WEIGHT_CODE_BITS) = code;
+    return beat;
+}
+
+// Effective synaptic weight of a stored code
+inline weight_t dequantize_weight(weight_code_t code, weight_scale_t shift) {
+    #pragma HLS INLINE
+#if WEIGHT_PRECISION == WEIGHT_PRECISION_INT8
+    (void)shift;
+    return code;
+#else
+    ap_int<WEIGHT_CODE_BITS + 8> value = ap_int<WEIGHT_CODE_BITS + 8>(code) << shift;
+    if (value > MAX_WEIGHT) return MAX_WEIGHT;
+    if (value < MIN_WEIGHT) return MIN_WEIGHT;
+    return value;
+#endif
+}
+
+// Host-side conversion between a flat code matrix and packed beats
+inline void pack_weights(const weight_code_t *weights, weight_beat_t *beats, int num_weights) {
+    for (int i = 0; i < num_weights; i++) {
+        int beat = i / WEIGHTS_PER_BEAT;
+        if (i % WEIGHTS_PER_BEAT == 0) beats[beat] = 0;
+        beats[beat] = weight_lane_set(beats[beat], i % WEIGHTS_PER_BEAT, weights[i]);
+    }
+}
+
+inline void unpack_weights(const weight_beat_t *beats, weight_code_t *weights, int num_weights) {
+    for (int i = 0; i < num_weights; i++) {
+        weights[i] = weight_lane_get(beats[i / WEIGHTS_PER_BEAT], i % WEIGHTS_PER_BEAT);
+    }
+}
+
+// Host-side compression of a dense matrix into CSR, returns the synapse count
+inline int dense_to_csr(
+    const weight_code_t *dense,
+    csr_ptr_t row_ptr[MAX_NEURONS + 1],
+    neuron_id_t *col_idx,
+    weight_code_t *values
+) {
+    int nnz = 0;
+    for (int pre = 0; pre < MAX_NEURONS; pre++) {
+        row_ptr[pre] = nnz;
+        for (int post = 0; post < MAX_NEURONS; post++) {
+            if (dense[pre * MAX_NEURONS + post] != 0) {
+                col_idx[nnz] = post;
+                values[nnz] = dense[pre * MAX_NEURONS + post];
+                nnz++;
+            }
+        }
+    }
+    row_ptr[MAX_NEURONS] = nnz;
+    return nnz;
+}
 void normalize_weights(weight_t *weights, int num_weights, ap_uint<16> target_sum);
 
 #endif // WEIGHT_UPDATER_H
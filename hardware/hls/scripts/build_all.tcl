@@ -62,6 +62,7 @@ if {$clean_first} {
         "weight_updater_prj"
         "spike_decoder_prj"
         "network_controller_prj"
+        "snn_pipeline_prj"
     }
     
     foreach proj $projects {
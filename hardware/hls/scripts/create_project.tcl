@@ -92,6 +92,13 @@ create_hls_project \
     "network_controller_prj" \
     "network_controller" \
     {network_controller.cpp} \
-    {test_utils.h}
+    {tb_network_controller.cpp test_utils.h}
+
+# Create end-to-end pipeline project
+create_hls_project \
+    "snn_pipeline_prj" \
+    "snn_pipeline" \
+    {snn_pipeline.cpp spike_encoder.cpp snn_learning_engine.cpp spike_decoder.cpp weight_updater.cpp} \
+    {tb_snn_pipeline.cpp test_utils.h}
 
 puts "All HLS projects created successfully!"
@@ -81,6 +81,12 @@ export_ip_core \
     "1.0" \
     "PYNQ-Z2-SNN"
 
+export_ip_core \
+    "snn_pipeline_prj" \
+    "snn_pipeline" \
+    "1.0" \
+    "PYNQ-Z2-SNN"
+
 puts "\n=========================================="
 puts "All IP cores exported to: $IP_REPO_PATH"
 puts "=========================================="
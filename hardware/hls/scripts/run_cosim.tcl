@@ -75,6 +75,9 @@ run_cosim_for_project "spike_decoder_prj" $basic_opts
 # Network Controller - verify control flow
 run_cosim_for_project "network_controller_prj" $basic_opts
 
+# SNN Pipeline - verify stage overlap across frames
+run_cosim_for_project "snn_pipeline_prj" $wave_opts
+
 puts "\n=========================================="
 puts "All co-simulations completed!"
 puts "Check individual reports for detailed results"
@@ -98,8 +98,13 @@ set encoder_directives {
 set weight_directives {
     "set_directive_interface -mode s_axilite weight_updater"
     "set_directive_interface -mode axis -register -register_mode both weight_updater updates_in"
-    "set_directive_interface -mode m_axi -depth 65536 -offset slave weight_updater weight_memory"
-    "set_directive_pipeline weight_updater"
+    "set_directive_interface -mode axis -register -register_mode both weight_updater dirty_out"
+    "set_directive_interface -mode m_axi -depth 8192 -offset slave weight_updater weight_memory"
+    "set_directive_pipeline -II 1 weight_updater/EPOCH_RESET_LOOP"
+    "set_directive_pipeline -II 1 decay_row/DECAY_ROW_LOOP"
+    "set_directive_pipeline -II 1 stream_dirty_rows/DIRTY_BEAT_LOOP"
+    "set_directive_pipeline -II 1 find_synapse/ROW_SEARCH_LOOP"
+    "set_directive_pipeline -II 1 build_decay_table/TABLE_LOOP"
     "set_directive_inline apply_decay"
 }
 
@@ -121,18 +126,42 @@ set controller_directives {
     "set_directive_interface -mode s_axilite network_controller"
     "set_directive_interface -mode axis -register -register_mode both network_controller input_data"
     "set_directive_interface -mode axis -register -register_mode both network_controller output_data"
+    "set_directive_interface -mode axis -register -register_mode both network_controller encoder_data"
+    "set_directive_interface -mode axis -register -register_mode both network_controller frame_ctrl"
     "set_directive_interface -mode axis -register -register_mode both network_controller encoder_ctrl"
     "set_directive_interface -mode axis -register -register_mode both network_controller learning_ctrl"
     "set_directive_interface -mode axis -register -register_mode both network_controller decoder_ctrl"
+    "set_directive_interface -mode axis -register -register_mode both network_controller decoder_results"
+    "set_directive_interface -mode m_axi -depth 256 -offset slave -bundle ring network_controller job_ring"
+    "set_directive_interface -mode m_axi -depth 256 -offset slave -bundle ring network_controller completions"
+    "set_directive_interface -mode m_axi -depth 256 -offset slave -bundle frames network_controller frame_memory"
+    "set_directive_interface -mode m_axi -depth 256 -offset slave -bundle frames network_controller result_memory"
     "set_directive_inline send_control_packet"
 }
 
+# End-to-end pipeline directives
+set pipeline_directives {
+    "set_directive_interface -mode s_axilite snn_pipeline"
+    "set_directive_interface -mode axis -register -register_mode both snn_pipeline input_data"
+    "set_directive_interface -mode axis -register -register_mode both snn_pipeline frame_ctrl"
+    "set_directive_interface -mode axis -register -register_mode both snn_pipeline output_data"
+    "set_directive_interface -mode axis -register -register_mode both snn_pipeline weight_updates"
+    "set_directive_interface -mode m_axi -depth 512 -offset slave snn_pipeline weight_memory"
+    "set_directive_dataflow snn_pipeline"
+    "set_directive_inline encode_rate"
+    "set_directive_inline encode_temporal"
+    "set_directive_inline encode_phase"
+    "set_directive_inline decode_spike_count"
+    "set_directive_inline decode_spike_rate"
+}
+
 # Run synthesis for all projects
 run_synthesis_for_project "snn_learning_engine_prj" $learning_directives
 run_synthesis_for_project "spike_encoder_prj" $encoder_directives
 run_synthesis_for_project "weight_updater_prj" $weight_directives
 run_synthesis_for_project "spike_decoder_prj" $decoder_directives
 run_synthesis_for_project "network_controller_prj" $controller_directives
+run_synthesis_for_project "snn_pipeline_prj" $pipeline_directives
 
 puts "\n=========================================="
 puts "All synthesis runs completed!"
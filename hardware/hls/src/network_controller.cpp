@@ -17,11 +17,31 @@ void network_controller(
     // Data streams
     hls::stream<input_data_t> &input_data,
     hls::stream<output_data_t> &output_data,
+    hls::stream<input_data_t> &encoder_data,
+    hls::stream<frame_control_t> &frame_ctrl,
     
     // Control streams to other modules
     hls::stream<control_packet_t> &encoder_ctrl,
     hls::stream<control_packet_t> &learning_ctrl,
     hls::stream<control_packet_t> &decoder_ctrl,
+    hls::stream<output_data_t> &decoder_results,
+    
+    // Context bank: CMD_STORE_CONTEXT writes context into slot context_id,
+    // ring jobs select a slot; the selected context goes out with each frame
+    network_context_t context,
+    ap_uint<8> context_id,
+    
+    // Job descriptor ring in DDR
+    const job_descriptor_t *job_ring,
+    const input_data_t *frame_memory,
+    output_data_t *result_memory,
+    job_completion_t *completions,
+    ap_uint<16> ring_size,
+    ap_uint<16> ring_tail,
+    ap_uint<16> &ring_head,
+    
+    // Global timestep, wired to every module
+    spike_time_t &timestep,
     
     // Status
     network_status_t &status
@@ -31,17 +51,40 @@ void network_controller(
     #pragma HLS INTERFACE s_axilite port=status
     #pragma HLS INTERFACE axis port=input_data
     #pragma HLS INTERFACE axis port=output_data
+    #pragma HLS INTERFACE axis port=encoder_data
+    #pragma HLS INTERFACE axis port=frame_ctrl
     #pragma HLS INTERFACE axis port=encoder_ctrl
     #pragma HLS INTERFACE axis port=learning_ctrl
     #pragma HLS INTERFACE axis port=decoder_ctrl
+    #pragma HLS INTERFACE axis port=decoder_results
+    #pragma HLS INTERFACE s_axilite port=context
+    #pragma HLS INTERFACE s_axilite port=context_id
+    #pragma HLS INTERFACE m_axi port=job_ring offset=slave bundle=ring depth=256
+    #pragma HLS INTERFACE m_axi port=completions offset=slave bundle=ring depth=256
+    #pragma HLS INTERFACE m_axi port=frame_memory offset=slave bundle=frames depth=256
+    #pragma HLS INTERFACE m_axi port=result_memory offset=slave bundle=frames depth=256
+    #pragma HLS INTERFACE s_axilite port=ring_size
+    #pragma HLS INTERFACE s_axilite port=ring_tail
+    #pragma HLS INTERFACE s_axilite port=ring_head
+    #pragma HLS INTERFACE ap_none port=timestep
     #pragma HLS INTERFACE s_axilite port=return
     
     static network_state_t state = STATE_IDLE;
     static ap_uint<32> cycle_counter = 0;
     static ap_uint<32> batch_counter = 0;
+    static ap_uint<16> head = 0;
+    static ap_uint<16> error_count = 0;
+    static spike_time_t global_time = 0;
+    static network_context_t context_bank[MAX_CONTEXTS];
+    static ap_uint<MAX_CONTEXTS> contexts_valid = 0;
+    static ap_uint<8> active_id = MAX_CONTEXTS;    // None selected yet
+    static performance_counter_t counters = {0, 0, 0, 0, 0};
+    
+    #pragma HLS ARRAY_PARTITION variable=context_bank complete
     
     // Update cycle counter
     cycle_counter++;
+    input_data_t frame;
     
     // State machine
     switch (state) {
@@ -49,36 +92,67 @@ void network_controller(
             if (command == CMD_START) {
                 state = STATE_INIT;
                 batch_counter = 0;
+            } else if (command == CMD_RUN_RING) {
+                // Everything queued so far runs in this call; returning raises ap_done
+                if (!process_job_ring(job_ring, frame_memory, result_memory, completions,
+                                      ring_size, ring_tail, head, context_bank,
+                                      contexts_valid, active_id, encoder_data,
+                                      frame_ctrl, decoder_results, global_time,
+                                      batch_counter, counters)) {
+                    error_count++;
+                }
+            } else if (command == CMD_STORE_CONTEXT) {
+                if (context_id < MAX_CONTEXTS) {
+                    context_bank[context_id] = context;
+                    contexts_valid[context_id] = 1;
+                } else {
+                    error_count++;
+                }
+            } else if (command == CMD_RESET) {
+                head = 0;
+                batch_counter = 0;
+                error_count = 0;
+                global_time = 0;
+                contexts_valid = 0;
+                active_id = MAX_CONTEXTS;
+                counters.reset();
             }
             break;
             
         case STATE_INIT:
             // Send initialization commands to all modules
-            send_control_packet(encoder_ctrl, CTRL_RESET, 0);
-            send_control_packet(learning_ctrl, CTRL_RESET, 0);
-            send_control_packet(decoder_ctrl, CTRL_RESET, 0);
+            global_time = 0;
+            send_control_packet(encoder_ctrl, CTRL_RESET, 0, global_time);
+            send_control_packet(learning_ctrl, CTRL_RESET, 0, global_time);
+            send_control_packet(decoder_ctrl, CTRL_RESET, 0, global_time);
             
             state = STATE_RUNNING;
             break;
             
         case STATE_RUNNING:
+            // One timestep per call while running
+            global_time++;
+            
             // Process input data
-            if (!input_data.empty()) {
-                input_data_t data = input_data.read();
-                
+            if (counted_read_nb(input_data, frame, counters)) {
                 // Configure encoder for this batch
                 control_packet_t enc_config;
                 enc_config.command = CTRL_CONFIGURE;
                 enc_config.param1 = config.encoding_type;
                 enc_config.param2 = config.input_scale;
+                enc_config.timestamp = global_time;
                 encoder_ctrl.write(enc_config);
                 
+                // Hand the frame itself to the encoder
+                counted_write_once(encoder_data, frame, counters);
+                
                 // Enable learning if in training mode
                 if (config.mode == MODE_TRAINING) {
                     control_packet_t learn_config;
                     learn_config.command = CTRL_ENABLE;
                     learn_config.param1 = config.learning_rate;
                     learn_config.param2 = config.stdp_window;
+                    learn_config.timestamp = global_time;
                     learning_ctrl.write(learn_config);
                 }
                 
@@ -108,7 +182,7 @@ void network_controller(
             
         case STATE_COMPLETE:
             // Send completion signal
-            send_control_packet(decoder_ctrl, CTRL_FLUSH, 0);
+            send_control_packet(decoder_ctrl, CTRL_FLUSH, 0, global_time);
             state = STATE_IDLE;
             break;
     }
@@ -117,13 +191,121 @@ void network_controller(
     status.state = state;
     status.cycles_run = cycle_counter;
     status.batches_processed = batch_counter;
-    status.errors = 0;
+    status.errors = error_count;
+    status.context_id = active_id;
+    status.contexts_valid = contexts_valid;
+    status.perf = counters;
+    ring_head = head;
+    timestep = global_time;
+}
+
+// Run every descriptor between head and ring_tail. Frames are issued up to
+// JOBS_IN_FLIGHT ahead of their results so the downstream pipeline stays busy.
+// Each frame goes out with a frame_control_t carrying the job's timestep
+// count, mode and start on the global timeline, which then advances by the
+// job's timesteps, plus the weight base and encoder/decoder configuration of
+// the stored context it runs under. Jobs naming an empty slot are completed
+// with JOB_STATUS_BAD_CONTEXT without touching the datapath.
+// Returns false when the ring registers are inconsistent.
+bool process_job_ring(
+    const job_descriptor_t *job_ring,
+    const input_data_t *frame_memory,
+    output_data_t *result_memory,
+    job_completion_t *completions,
+    ap_uint<16> ring_size,
+    ap_uint<16> ring_tail,
+    ap_uint<16> &head,
+    const network_context_t context_bank[MAX_CONTEXTS],
+    ap_uint<MAX_CONTEXTS> contexts_valid,
+    ap_uint<8> &active_id,
+    hls::stream<input_data_t> &encoder_data,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<output_data_t> &decoder_results,
+    spike_time_t &global_time,
+    ap_uint<32> &jobs_done,
+    performance_counter_t &perf
+) {
+    if (ring_size == 0 || ring_tail >= ring_size) {
+        return false;
+    }
+    
+    ap_uint<16> pending = (ring_tail >= head) ? ap_uint<16>(ring_tail - head)
+                                              : ap_uint<16>(ring_size - head + ring_tail);
+    ap_uint<16> issue_idx = head;
+    ap_uint<16> collect_idx = head;
+    
+    // Descriptors of issued jobs still waiting for a result
+    job_descriptor_t in_flight[JOBS_IN_FLIGHT];
+    bool job_has_context[JOBS_IN_FLIGHT];
+    #pragma HLS ARRAY_PARTITION variable=in_flight complete
+    #pragma HLS ARRAY_PARTITION variable=job_has_context complete
+    
+    JOB_LOOP: for (int i = 0; i < pending + JOBS_IN_FLIGHT; i++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=256
+        
+        // Retire the job issued JOBS_IN_FLIGHT iterations ago (frees its slot)
+        if (i >= JOBS_IN_FLIGHT) {
+            job_descriptor_t job = in_flight[i % JOBS_IN_FLIGHT];
+            job_completion_t done;
+            done.job_id = job.job_id;
+            done.reserved = 0;
+            
+            if (job_has_context[i % JOBS_IN_FLIGHT]) {
+                output_data_t result = counted_read(decoder_results, perf);
+                result_memory[job.output_addr] = result;
+                done.frame_id = result.frame_id;
+                done.class_id = result.class_id;
+                done.confidence = result.confidence;
+                done.status = JOB_STATUS_DONE;
+            } else {
+                done.frame_id = 0;
+                done.class_id = 0;
+                done.confidence = 0;
+                done.status = JOB_STATUS_BAD_CONTEXT;
+            }
+            completions[collect_idx] = done;
+            
+            collect_idx = (collect_idx == ring_size - 1) ? ap_uint<16>(0) : ap_uint<16>(collect_idx + 1);
+            jobs_done++;
+            perf.update(true, false);
+        }
+        
+        if (i < pending) {
+            job_descriptor_t job = job_ring[issue_idx];
+            bool has_context = job.context_id < MAX_CONTEXTS && contexts_valid[job.context_id];
+            in_flight[i % JOBS_IN_FLIGHT] = job;
+            job_has_context[i % JOBS_IN_FLIGHT] = has_context;
+            
+            if (has_context) {
+                const network_context_t &context = context_bank[job.context_id];
+                active_id = job.context_id;
+                
+                frame_control_t ctrl;
+                ctrl.start_time = global_time;
+                ctrl.timesteps = job.timesteps;
+                ctrl.mode = job.mode;
+                ctrl.context_id = job.context_id;
+                ctrl.weight_base = context.weight_base;
+                ctrl.encoder = context.encoder;
+                ctrl.decoder = context.decoder;
+                counted_write(frame_ctrl, ctrl, perf);
+                counted_write(encoder_data, frame_memory[job.input_addr], perf);
+                global_time += job.timesteps;
+            }
+            
+            issue_idx = (issue_idx == ring_size - 1) ? ap_uint<16>(0) : ap_uint<16>(issue_idx + 1);
+        }
+    }
+    
+    head = collect_idx;
+    return true;
 }
 
 void send_control_packet(
     hls::stream<control_packet_t> &stream,
     control_command_t cmd,
-    ap_uint<16> param
+    ap_uint<16> param,
+    spike_time_t timestamp
 ) {
     #pragma HLS INLINE
     
@@ -131,7 +313,7 @@ void send_control_packet(
     packet.command = cmd;
     packet.param1 = param;
     packet.param2 = 0;
-    packet.timestamp = 0; // Would use global timestamp in real implementation
+    packet.timestamp = timestamp;
     
     stream.write(packet);
 }
@@ -15,7 +15,9 @@ void snn_learning_engine(
     // Control interface
     bool enable,
     bool reset,
-    learning_config_t config,
+    spike_time_t timestep,      // Global timestep
+    learning_config_t shadow_config,
+    ap_uint<8> commit_seq,      // Bump to commit shadow_config
     
     // Spike input streams
     hls::stream<spike_event_t> &pre_spikes,
@@ -24,26 +26,51 @@ void snn_learning_engine(
     // Weight update stream
     hls::stream<weight_update_t> &weight_updates,
     
+    // Checkpoint buffer in DDR
+    checkpoint_command_t checkpoint,
+    ap_uint<32> *checkpoint_memory,
+    
     // Status output
-    ap_uint<32> &status
+    ap_uint<32> &status,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 ) {
     #pragma HLS INTERFACE s_axilite port=enable
     #pragma HLS INTERFACE s_axilite port=reset
-    #pragma HLS INTERFACE s_axilite port=config
+    #pragma HLS INTERFACE ap_none port=timestep
+    #pragma HLS INTERFACE s_axilite port=shadow_config
+    #pragma HLS INTERFACE s_axilite port=commit_seq
     #pragma HLS INTERFACE s_axilite port=status
+    #pragma HLS INTERFACE s_axilite port=active_seq
+    #pragma HLS INTERFACE s_axilite port=perf
     #pragma HLS INTERFACE axis port=pre_spikes
     #pragma HLS INTERFACE axis port=post_spikes
     #pragma HLS INTERFACE axis port=weight_updates
+    #pragma HLS INTERFACE s_axilite port=checkpoint
+    #pragma HLS INTERFACE m_axi port=checkpoint_memory offset=slave bundle=ckpt depth=CKPT_WORDS max_write_burst_length=64 max_read_burst_length=64
     #pragma HLS INTERFACE s_axilite port=return
     
     // Internal state
     static spike_time_t pre_spike_times[MAX_NEURONS];
     static spike_time_t post_spike_times[MAX_NEURONS];
     static ap_uint<32> update_counter = 0;
+    static performance_counter_t counters = {0, 0, 0, 0, 0};
+    static spike_event_t held_pre, held_post;
+    static bool pre_held = false, post_held = false;
+    static shadow_config_t<learning_config_t> config_bank;
     
     #pragma HLS ARRAY_PARTITION variable=pre_spike_times cyclic factor=8
     #pragma HLS ARRAY_PARTITION variable=post_spike_times cyclic factor=8
     
+    if (reset) {
+        config_bank.reset();
+    }
+    
+    // Commit between timesteps: no spike of a later step is held back
+    config_bank.commit(shadow_config, commit_seq, !pre_held && !post_held);
+    learning_config_t config = config_bank.active;
+    active_seq = config_bank.seq;
+    
     if (reset) {
         RESET_LOOP: for (int i = 0; i < MAX_NEURONS; i++) {
             #pragma HLS PIPELINE II=1
@@ -51,78 +78,150 @@ void snn_learning_engine(
             post_spike_times[i] = 0;
         }
         update_counter = 0;
+        pre_held = false;
+        post_held = false;
+        counters.reset();
         status = 0;
+        perf = counters;
+        return;
+    }
+    
+    // Checkpoints run instead of a timestep and work while disabled, so the
+    // host can stop the engine, save it, and restore it later
+    if (checkpoint == CKPT_SAVE) {
+        // Sequential addresses: each table goes out as a single burst
+        SAVE_PRE_TIMES: for (int i = 0; i < MAX_NEURONS; i++) {
+            #pragma HLS PIPELINE II=1
+            checkpoint_memory[CKPT_PRE_TIMES + i] = pre_spike_times[i];
+        }
+        SAVE_POST_TIMES: for (int i = 0; i < MAX_NEURONS; i++) {
+            #pragma HLS PIPELINE II=1
+            checkpoint_memory[CKPT_POST_TIMES + i] = post_spike_times[i];
+        }
+        checkpoint_memory[CKPT_UPDATE_COUNT] = update_counter;
+        checkpoint_memory[CKPT_HELD] = (ap_uint<32>(post_held) << 1) | ap_uint<32>(pre_held);
+        checkpoint_memory[CKPT_HELD + 1] = held_pre.neuron_id;
+        checkpoint_memory[CKPT_HELD + 2] = held_pre.timestamp;
+        checkpoint_memory[CKPT_HELD + 3] = ap_uint<8>(held_pre.weight);
+        checkpoint_memory[CKPT_HELD + 4] = held_post.neuron_id;
+        checkpoint_memory[CKPT_HELD + 5] = held_post.timestamp;
+        checkpoint_memory[CKPT_HELD + 6] = ap_uint<8>(held_post.weight);
+        status = update_counter;
+        perf = counters;
+        return;
+    }
+    
+    if (checkpoint == CKPT_RESTORE) {
+        RESTORE_PRE_TIMES: for (int i = 0; i < MAX_NEURONS; i++) {
+            #pragma HLS PIPELINE II=1
+            pre_spike_times[i] = checkpoint_memory[CKPT_PRE_TIMES + i];
+        }
+        RESTORE_POST_TIMES: for (int i = 0; i < MAX_NEURONS; i++) {
+            #pragma HLS PIPELINE II=1
+            post_spike_times[i] = checkpoint_memory[CKPT_POST_TIMES + i];
+        }
+        update_counter = checkpoint_memory[CKPT_UPDATE_COUNT];
+        ap_uint<32> held = checkpoint_memory[CKPT_HELD];
+        pre_held = held[0];
+        post_held = held[1];
+        held_pre.neuron_id = checkpoint_memory[CKPT_HELD + 1];
+        held_pre.timestamp = checkpoint_memory[CKPT_HELD + 2];
+        held_pre.weight = ap_uint<8>(checkpoint_memory[CKPT_HELD + 3]);
+        held_post.neuron_id = checkpoint_memory[CKPT_HELD + 4];
+        held_post.timestamp = checkpoint_memory[CKPT_HELD + 5];
+        held_post.weight = ap_uint<8>(checkpoint_memory[CKPT_HELD + 6]);
+        status = update_counter;
+        perf = counters;
         return;
     }
     
     if (!enable) {
         status = 0x80000000; // Disabled flag
+        perf = counters;
         return;
     }
     
-    // Process pre-synaptic spikes
-    if (!pre_spikes.empty()) {
-        spike_event_t pre_event = pre_spikes.read();
-        neuron_id_t pre_id = pre_event.neuron_id;
-        spike_time_t pre_time = pre_event.timestamp;
+    // Drain every spike that is due by the global timestep, oldest first, so
+    // pairs form in time order however the spikes were batched. The first
+    // spike from a later step stays held until the timestep reaches it.
+    BATCH_LOOP: for (int i = 0; i < MAX_SPIKES_PER_STEP; i++) {
+        if (!pre_held) {
+            pre_held = counted_read_nb(pre_spikes, held_pre, counters);
+        }
+        if (!post_held) {
+            post_held = counted_read_nb(post_spikes, held_post, counters);
+        }
         
-        if (pre_id < MAX_NEURONS) {
-            pre_spike_times[pre_id] = pre_time;
+        bool pre_due = pre_held && held_pre.timestamp <= timestep;
+        bool post_due = post_held && held_post.timestamp <= timestep;
+        if (!pre_due && !post_due) {
+            break;
+        }
+        
+        if (pre_due && (!post_due || held_pre.timestamp <= held_post.timestamp)) {
+            // Process pre-synaptic spike
+            spike_event_t pre_event = held_pre;
+            pre_held = false;
+            neuron_id_t pre_id = pre_event.neuron_id;
+            spike_time_t pre_time = pre_event.timestamp;
             
-            // Check for post-pre spike pairs (LTD)
-            LTD_LOOP: for (int post_id = 0; post_id < MAX_NEURONS; post_id++) {
-                #pragma HLS PIPELINE II=2
-                if (post_spike_times[post_id] > 0) {
-                    ap_int<32> dt = pre_time - post_spike_times[post_id];
-                    
-                    if (dt > 0 && dt < config.stdp_window) {
-                        // Calculate LTD weight change
-                        weight_delta_t delta = calculate_ltd(dt, config);
+            if (pre_id < MAX_NEURONS) {
+                pre_spike_times[pre_id] = pre_time;
+                
+                // Check for post-pre spike pairs (LTD)
+                LTD_LOOP: for (int post_id = 0; post_id < MAX_NEURONS; post_id++) {
+                    #pragma HLS PIPELINE II=2
+                    if (post_spike_times[post_id] > 0) {
+                        ap_int<32> dt = pre_time - post_spike_times[post_id];
                         
-                        if (delta != 0) {
-                            weight_update_t update;
-                            update.pre_id = pre_id;
-                            update.post_id = post_id;
-                            update.delta = delta;
-                            update.timestamp = pre_time;
+                        if (dt > 0 && dt < config.stdp_window) {
+                            // Calculate LTD weight change
+                            weight_delta_t delta = calculate_ltd(dt, config);
                             
-                            weight_updates.write(update);
-                            update_counter++;
+                            if (delta != 0) {
+                                weight_update_t update;
+                                update.pre_id = pre_id;
+                                update.post_id = post_id;
+                                update.delta = delta;
+                                update.timestamp = pre_time;
+                                
+                                counted_write_once(weight_updates, update, counters);
+                                update_counter++;
+                            }
                         }
                     }
                 }
             }
-        }
-    }
-    
-    // Process post-synaptic spikes
-    if (!post_spikes.empty()) {
-        spike_event_t post_event = post_spikes.read();
-        neuron_id_t post_id = post_event.neuron_id;
-        spike_time_t post_time = post_event.timestamp;
-        
-        if (post_id < MAX_NEURONS) {
-            post_spike_times[post_id] = post_time;
+        } else {
+            // Process post-synaptic spike
+            spike_event_t post_event = held_post;
+            post_held = false;
+            neuron_id_t post_id = post_event.neuron_id;
+            spike_time_t post_time = post_event.timestamp;
             
-            // Check for pre-post spike pairs (LTP)
-            LTP_LOOP: for (int pre_id = 0; pre_id < MAX_NEURONS; pre_id++) {
-                #pragma HLS PIPELINE II=2
-                if (pre_spike_times[pre_id] > 0) {
-                    ap_int<32> dt = post_time - pre_spike_times[pre_id];
-                    
-                    if (dt > 0 && dt < config.stdp_window) {
-                        // Calculate LTP weight change
-                        weight_delta_t delta = calculate_ltp(dt, config);
+            if (post_id < MAX_NEURONS) {
+                post_spike_times[post_id] = post_time;
+                
+                // Check for pre-post spike pairs (LTP)
+                LTP_LOOP: for (int pre_id = 0; pre_id < MAX_NEURONS; pre_id++) {
+                    #pragma HLS PIPELINE II=2
+                    if (pre_spike_times[pre_id] > 0) {
+                        ap_int<32> dt = post_time - pre_spike_times[pre_id];
                         
-                        if (delta != 0) {
-                            weight_update_t update;
-                            update.pre_id = pre_id;
-                            update.post_id = post_id;
-                            update.delta = delta;
-                            update.timestamp = post_time;
+                        if (dt > 0 && dt < config.stdp_window) {
+                            // Calculate LTP weight change
+                            weight_delta_t delta = calculate_ltp(dt, config);
                             
-                            weight_updates.write(update);
-                            update_counter++;
+                            if (delta != 0) {
+                                weight_update_t update;
+                                update.pre_id = pre_id;
+                                update.post_id = post_id;
+                                update.delta = delta;
+                                update.timestamp = post_time;
+                                
+                                counted_write_once(weight_updates, update, counters);
+                                update_counter++;
+                            }
                         }
                     }
                 }
@@ -132,6 +231,7 @@ void snn_learning_engine(
     
     // Update status
     status = update_counter;
+    perf = counters;
 }
 
 // Calculate LTP (Long-Term Potentiation) weight change
@@ -0,0 +1,599 @@
+//-----------------------------------------------------------------------------
+// Title         : SNN Pipeline
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : snn_pipeline.cpp
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Frame-level DATAFLOW kernel with dispatch, encoder, neuron
+//                 core, learning and decoder stages
+//-----------------------------------------------------------------------------
+
+#include "snn_pipeline.h"
+
+void snn_pipeline(
+    // Configuration
+    network_config_t config,
+    encoder_config_t enc_config,
+    core_config_t core_config,
+    learning_config_t learn_config,
+    decoder_config_t dec_config,
+    spike_time_t start_time,        // Global timestep of the first encoded step
+
+    // Frames in, with per-frame control from the job ring when frame_ctrl_en
+    hls::stream<input_data_t> &input_data,
+    bool frame_ctrl_en,
+    hls::stream<frame_control_t> &frame_ctrl,
+
+    // Synaptic weights (packed, dense layout); weight_base picks the model
+    // unless frame control carries one
+    const weight_beat_t *weight_memory,
+    ap_uint<32> weight_base,
+    const weight_scale_t row_scale[MAX_NEURONS],
+
+    // Lazy decay state kept by weight_updater, and its active config
+    const decay_epoch_t *row_epoch,
+    weight_config_t weight_config,
+
+    // Results out
+    hls::stream<output_data_t> &output_data,
+    hls::stream<weight_update_t> &weight_updates,
+
+    // Status
+    ap_uint<32> &frames_done,
+    ap_uint<32> &spikes_encoded,
+    ap_uint<32> &spikes_fired,
+    ap_uint<32> &updates_issued,
+    pipeline_status_t *status_block
+) {
+    #pragma HLS INTERFACE s_axilite port=config
+    #pragma HLS INTERFACE s_axilite port=enc_config
+    #pragma HLS INTERFACE s_axilite port=core_config
+    #pragma HLS INTERFACE s_axilite port=learn_config
+    #pragma HLS INTERFACE s_axilite port=dec_config
+    #pragma HLS INTERFACE ap_none port=start_time
+    #pragma HLS INTERFACE s_axilite port=frame_ctrl_en
+    #pragma HLS INTERFACE s_axilite port=row_scale
+    #pragma HLS INTERFACE s_axilite port=weight_base
+    #pragma HLS INTERFACE s_axilite port=weight_config
+    #pragma HLS INTERFACE s_axilite port=frames_done
+    #pragma HLS INTERFACE s_axilite port=spikes_encoded
+    #pragma HLS INTERFACE s_axilite port=spikes_fired
+    #pragma HLS INTERFACE s_axilite port=updates_issued
+    #pragma HLS INTERFACE axis port=input_data
+    #pragma HLS INTERFACE axis port=frame_ctrl
+    #pragma HLS INTERFACE axis port=output_data
+    #pragma HLS INTERFACE axis port=weight_updates
+    #pragma HLS INTERFACE m_axi port=weight_memory offset=slave depth=512 max_read_burst_length=64
+    #pragma HLS INTERFACE m_axi port=row_epoch offset=slave bundle=epoch depth=64
+    #pragma HLS INTERFACE m_axi port=status_block offset=slave bundle=status depth=1
+    #pragma HLS INTERFACE s_axilite port=return
+
+    #pragma HLS DATAFLOW
+
+    hls::stream<input_data_t> frames("frames");
+    hls::stream<ap_uint<32> > frame_ids("frame_ids");
+    hls::stream<frame_control_t> encoder_ctrl("encoder_ctrl");
+    hls::stream<frame_control_t> core_ctrl("core_ctrl");
+    hls::stream<frame_control_t> learning_ctrl("learning_ctrl");
+    hls::stream<frame_control_t> decoder_ctrl("decoder_ctrl");
+    hls::stream<spike_event_t> input_spikes("input_spikes");
+    hls::stream<spike_event_t> pre_spikes("pre_spikes");
+    hls::stream<spike_event_t> post_spikes("post_spikes");
+    hls::stream<spike_event_t> output_spikes("output_spikes");
+    hls::stream<performance_counter_t> dispatch_perf("dispatch_perf");
+    hls::stream<performance_counter_t> encoder_perf("encoder_perf");
+    hls::stream<performance_counter_t> core_perf("core_perf");
+    hls::stream<performance_counter_t> learning_perf("learning_perf");
+    hls::stream<performance_counter_t> decoder_perf("decoder_perf");
+
+    #pragma HLS STREAM variable=frames depth=2
+    #pragma HLS STREAM variable=frame_ids depth=FRAME_FIFO_DEPTH
+    #pragma HLS STREAM variable=encoder_ctrl depth=2
+    #pragma HLS STREAM variable=core_ctrl depth=FRAME_FIFO_DEPTH
+    #pragma HLS STREAM variable=learning_ctrl depth=FRAME_FIFO_DEPTH
+    #pragma HLS STREAM variable=decoder_ctrl depth=FRAME_FIFO_DEPTH
+    #pragma HLS STREAM variable=input_spikes depth=SPIKE_FIFO_DEPTH
+    #pragma HLS STREAM variable=pre_spikes depth=SPIKE_FIFO_DEPTH
+    #pragma HLS STREAM variable=post_spikes depth=SPIKE_FIFO_DEPTH
+    #pragma HLS STREAM variable=output_spikes depth=SPIKE_FIFO_DEPTH
+
+    dispatch_frames(config.batch_size, config.mode, enc_config, dec_config, weight_base,
+                    start_time, frame_ctrl_en, input_data, frame_ctrl, frames, encoder_ctrl,
+                    core_ctrl, learning_ctrl, decoder_ctrl, frame_ids, dispatch_perf);
+
+    encode_frames(config.batch_size, encoder_ctrl, frames, input_spikes, spikes_encoded,
+                  encoder_perf);
+
+    neuron_core(config.batch_size, core_config, core_ctrl, weight_memory, row_scale,
+                row_epoch, weight_config, input_spikes, pre_spikes, post_spikes,
+                output_spikes, spikes_fired, core_perf);
+
+    learn_frames(config.batch_size, learn_config, learning_ctrl, pre_spikes, post_spikes,
+                 weight_updates, updates_issued, learning_perf);
+
+    decode_frames(config.batch_size, decoder_ctrl, output_spikes, frame_ids, output_data,
+                  frames_done, decoder_perf);
+
+    report_status(dispatch_perf, encoder_perf, core_perf, learning_perf, decoder_perf,
+                  status_block);
+}
+
+// Dispatch stage: hand each frame to the encoder, its id to the decoder, and
+// its control (from the ring, or the batch registers) to every stage
+void dispatch_frames(
+    ap_uint<16> num_frames,
+    ap_uint<8> mode,
+    encoder_config_t enc_config,
+    decoder_config_t dec_config,
+    ap_uint<32> weight_base,
+    spike_time_t start_time,
+    bool frame_ctrl_en,
+    hls::stream<input_data_t> &input_data,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<input_data_t> &frames,
+    hls::stream<frame_control_t> &encoder_ctrl,
+    hls::stream<frame_control_t> &core_ctrl,
+    hls::stream<frame_control_t> &learning_ctrl,
+    hls::stream<frame_control_t> &decoder_ctrl,
+    hls::stream<ap_uint<32> > &frame_ids,
+    hls::stream<performance_counter_t> &perf_out
+) {
+    performance_counter_t perf;
+    perf.reset();
+
+    frame_control_t ctrl;
+    ctrl.start_time = start_time;
+    ctrl.timesteps = enc_config.time_window;
+    ctrl.mode = mode;
+    ctrl.context_id = 0;
+    ctrl.weight_base = weight_base;
+    ctrl.encoder = enc_config;
+    ctrl.decoder = dec_config;
+
+    DISPATCH_LOOP: for (int f = 0; f < num_frames; f++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        if (frame_ctrl_en) {
+            ctrl = counted_read(frame_ctrl, perf);
+        }
+        input_data_t data = counted_read(input_data, perf);
+        counted_write(frame_ids, data.frame_id, perf);
+        counted_write(encoder_ctrl, ctrl, perf);
+        counted_write(core_ctrl, ctrl, perf);
+        counted_write(learning_ctrl, ctrl, perf);
+        counted_write(decoder_ctrl, ctrl, perf);
+        counted_write(frames, data, perf);
+        perf.update(true, false);
+        ctrl.start_time += ctrl.timesteps;
+    }
+
+    perf_out.write(perf);
+}
+
+// Encoder stage: one marker-terminated spike burst per timestep, stamped on
+// the global timeline so later stages see the same time as the controller
+void encode_frames(
+    ap_uint<16> num_frames,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<input_data_t> &frames,
+    hls::stream<spike_event_t> &spikes_out,
+    ap_uint<32> &spike_count,
+    hls::stream<performance_counter_t> &perf_out
+) {
+    ap_uint<16> phase_acc[MAX_NEURONS];
+    #pragma HLS ARRAY_PARTITION variable=phase_acc cyclic factor=8
+
+    ap_uint<32> total_spikes = 0;
+    performance_counter_t perf;
+    perf.reset();
+
+    FRAME_LOOP: for (int f = 0; f < num_frames; f++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        frame_control_t ctrl = counted_read(frame_ctrl, perf);
+        input_data_t data = counted_read(frames, perf);
+        spike_time_t time = ctrl.start_time;
+
+        // Temporal codes spread over the frame's own length
+        encoder_config_t frame_config = ctrl.encoder;
+        frame_config.time_window = (ctrl.timesteps == 0) ? ap_uint<16>(1) : ctrl.timesteps;
+
+        PHASE_RESET: for (int ch = 0; ch < MAX_NEURONS; ch++) {
+            #pragma HLS UNROLL factor=8
+            phase_acc[ch] = 0;
+        }
+
+        STEP_LOOP: for (int t = 0; t < ctrl.timesteps; t++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=100
+
+            // Only the first MAX_NEURONS channels have an axon in the core
+            CHANNEL_LOOP: for (int ch = 0; ch < MAX_NEURONS; ch++) {
+                #pragma HLS PIPELINE II=1
+                perf.update(ch < frame_config.num_channels, false);
+                if (ch < frame_config.num_channels) {
+                    pixel_t pixel_value = data.pixels[ch];
+
+                    switch (frame_config.encoding_type) {
+                        case RATE_CODING:
+                            encode_rate(ch, pixel_value, time, frame_config, spikes_out,
+                                        total_spikes, perf);
+                            break;
+
+                        case TEMPORAL_CODING:
+                            encode_temporal(ch, pixel_value, time, frame_config, spikes_out,
+                                            total_spikes, perf);
+                            break;
+
+                        case PHASE_CODING:
+                            encode_phase(ch, pixel_value, time, frame_config,
+                                         phase_acc[ch], spikes_out, total_spikes, perf);
+                            break;
+
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            spike_event_t marker;
+            marker.neuron_id = SPIKE_STEP_END;
+            marker.timestamp = time;
+            marker.weight = 0;
+            counted_write(spikes_out, marker, perf);
+
+            time++;
+        }
+    }
+
+    spike_count = total_spikes;
+    perf_out.write(perf);
+}
+
+// Neuron core stage: integrate-and-fire over one layer of MAX_NEURONS neurons
+void neuron_core(
+    ap_uint<16> num_frames,
+    core_config_t config,
+    hls::stream<frame_control_t> &frame_ctrl,
+    const weight_beat_t *weight_memory,
+    const weight_scale_t row_scale[MAX_NEURONS],
+    const decay_epoch_t *row_epoch,
+    weight_config_t weight_config,
+    hls::stream<spike_event_t> &spikes_in,
+    hls::stream<spike_event_t> &pre_spikes,
+    hls::stream<spike_event_t> &post_spikes,
+    hls::stream<spike_event_t> &spikes_out,
+    ap_uint<32> &spike_count,
+    hls::stream<performance_counter_t> &perf_out
+) {
+    weight_t weights[MAX_NEURONS][MAX_NEURONS];
+    potential_t potential[MAX_NEURONS];
+    ap_uint<8> refractory[MAX_NEURONS];
+    decay_factor_t row_decay[MAX_NEURONS];
+    decay_factor_t decay_pow[DECAY_POW_BITS];
+    #pragma HLS ARRAY_PARTITION variable=weights cyclic factor=WEIGHTS_PER_BEAT dim=2
+    #pragma HLS ARRAY_PARTITION variable=decay_pow complete
+
+    potential_t leak = config.leak_rate;
+    potential_t threshold = config.threshold;
+    ap_uint<32> total_spikes = 0;
+    performance_counter_t perf;
+    perf.reset();
+
+    if (weight_config.enable_decay) {
+        build_decay_table(weight_config.decay_rate, decay_pow);
+    }
+
+    FRAME_LOOP: for (int f = 0; f < num_frames; f++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        frame_control_t ctrl = counted_read(frame_ctrl, perf);
+
+        // Rows the updater has not touched lately still owe decay: apply it
+        // to the loaded copy and leave committing it to the next touch
+        decay_epoch_t epoch = ctrl.start_time >> weight_config.decay_epoch_shift;
+        ROW_DECAY: for (int row = 0; row < MAX_NEURONS; row++) {
+            #pragma HLS PIPELINE II=1
+            row_decay[row] = weight_config.enable_decay
+                ? decay_factor(owed_epochs(epoch, row_epoch[row]), decay_pow)
+                : decay_factor_t(1 << DECAY_FRAC_BITS);
+        }
+
+        // Pick up whatever the weight updater has written since the last
+        // frame, from the frame's own model
+        WEIGHT_LOAD: for (int b = 0; b < WEIGHT_BEATS; b++) {
+            #pragma HLS PIPELINE II=1
+            weight_beat_t beat = weight_memory[ctrl.weight_base + b];
+            int row = (b * WEIGHTS_PER_BEAT) / MAX_NEURONS;
+            int col = (b * WEIGHTS_PER_BEAT) % MAX_NEURONS;
+            LANE_LOOP: for (int lane = 0; lane < WEIGHTS_PER_BEAT; lane++) {
+                weight_code_t code = apply_decay(weight_lane_get(beat, lane), row_decay[row]);
+                weights[row][col + lane] = dequantize_weight(code, row_scale[row]);
+            }
+        }
+
+        STATE_RESET: for (int n = 0; n < MAX_NEURONS; n++) {
+            #pragma HLS PIPELINE II=1
+            potential[n] = 0;
+            refractory[n] = 0;
+        }
+
+        STEP_LOOP: for (int t = 0; t < ctrl.timesteps; t++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=100
+            spike_time_t now = 0;
+            bool step_done = false;
+
+            // Integrate this timestep's input spikes (also the learning pre-spikes)
+            INTEGRATE_LOOP: while (!step_done) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=65
+                spike_event_t spike = counted_read(spikes_in, perf);
+                counted_write(pre_spikes, spike, perf);
+                perf.update(true, false);
+
+                if (spike.neuron_id == SPIKE_STEP_END) {
+                    now = spike.timestamp;
+                    step_done = true;
+                } else if (spike.neuron_id < MAX_NEURONS) {
+                    ACCUM_LOOP: for (int post = 0; post < MAX_NEURONS; post++) {
+                        #pragma HLS PIPELINE II=1
+                        ap_int<21> sum = potential[post] + weights[spike.neuron_id][post];
+                        if (sum > POTENTIAL_MAX) sum = POTENTIAL_MAX;
+                        if (sum < POTENTIAL_MIN) sum = POTENTIAL_MIN;
+                        potential[post] = sum;
+                    }
+                }
+            }
+
+            // Leak, threshold and fire
+            FIRE_LOOP: for (int n = 0; n < MAX_NEURONS; n++) {
+                #pragma HLS PIPELINE II=1
+                perf.update(true, false);
+                potential_t v = potential[n];
+
+                if (refractory[n] > 0) {
+                    refractory[n]--;
+                    v = 0;
+                } else {
+                    if (v > leak) {
+                        v -= leak;
+                    } else if (v < -leak) {
+                        v += leak;
+                    } else {
+                        v = 0;
+                    }
+
+                    if (v >= threshold) {
+                        spike_event_t spike;
+                        spike.neuron_id = n;
+                        spike.timestamp = now;
+                        spike.weight = 0;
+                        counted_write(spikes_out, spike, perf);
+                        counted_write(post_spikes, spike, perf);
+                        total_spikes++;
+
+                        v = 0;
+                        refractory[n] = config.refractory_period;
+                    }
+                }
+
+                potential[n] = v;
+            }
+
+            spike_event_t marker;
+            marker.neuron_id = SPIKE_STEP_END;
+            marker.timestamp = now;
+            marker.weight = 0;
+            counted_write(spikes_out, marker, perf);
+            counted_write(post_spikes, marker, perf);
+        }
+    }
+
+    spike_count = total_spikes;
+    perf_out.write(perf);
+}
+
+// Learning stage: pair-based STDP over the timestep index within a frame
+void learn_frames(
+    ap_uint<16> num_frames,
+    learning_config_t config,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<spike_event_t> &pre_spikes,
+    hls::stream<spike_event_t> &post_spikes,
+    hls::stream<weight_update_t> &weight_updates,
+    ap_uint<32> &update_count,
+    hls::stream<performance_counter_t> &perf_out
+) {
+    // Last spike step + 1 per neuron, 0 = no spike yet this frame
+    ap_uint<17> pre_step[MAX_NEURONS];
+    ap_uint<17> post_step[MAX_NEURONS];
+    #pragma HLS ARRAY_PARTITION variable=pre_step cyclic factor=8
+    #pragma HLS ARRAY_PARTITION variable=post_step cyclic factor=8
+
+    ap_uint<32> total_updates = 0;
+    performance_counter_t perf;
+    perf.reset();
+
+    FRAME_LOOP: for (int f = 0; f < num_frames; f++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        frame_control_t ctrl = counted_read(frame_ctrl, perf);
+        bool training = (ctrl.mode == MODE_TRAINING);
+
+        CLEAR_LOOP: for (int i = 0; i < MAX_NEURONS; i++) {
+            #pragma HLS PIPELINE II=1
+            pre_step[i] = 0;
+            post_step[i] = 0;
+        }
+
+        STEP_LOOP: for (int t = 0; t < ctrl.timesteps; t++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=100
+            ap_uint<17> step = t + 1;
+            bool step_done = false;
+
+            // Pre-synaptic spikes after a post spike depress (LTD)
+            PRE_LOOP: while (!step_done) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=65
+                spike_event_t pre_event = counted_read(pre_spikes, perf);
+                perf.update(true, false);
+                neuron_id_t pre_id = pre_event.neuron_id;
+
+                if (pre_id == SPIKE_STEP_END) {
+                    step_done = true;
+                } else if (pre_id < MAX_NEURONS) {
+                    pre_step[pre_id] = step;
+
+                    LTD_LOOP: for (int post_id = 0; post_id < MAX_NEURONS; post_id++) {
+                        #pragma HLS PIPELINE II=2
+                        if (training && post_step[post_id] > 0) {
+                            ap_int<32> dt = step - post_step[post_id];
+                            weight_delta_t delta = calculate_ltd(dt, config);
+
+                            if (delta != 0) {
+                                weight_update_t update;
+                                update.pre_id = pre_id;
+                                update.post_id = post_id;
+                                update.delta = delta;
+                                update.timestamp = pre_event.timestamp;
+
+                                counted_write(weight_updates, update, perf);
+                                total_updates++;
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Post-synaptic spikes after a pre spike potentiate (LTP)
+            step_done = false;
+            POST_LOOP: while (!step_done) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=65
+                spike_event_t post_event = counted_read(post_spikes, perf);
+                perf.update(true, false);
+                neuron_id_t post_id = post_event.neuron_id;
+
+                if (post_id == SPIKE_STEP_END) {
+                    step_done = true;
+                } else if (post_id < MAX_NEURONS) {
+                    post_step[post_id] = step;
+
+                    LTP_LOOP: for (int pre_id = 0; pre_id < MAX_NEURONS; pre_id++) {
+                        #pragma HLS PIPELINE II=2
+                        if (training && pre_step[pre_id] > 0) {
+                            // Output spikes follow the step's integration, so an
+                            // input from this same step precedes them by one
+                            ap_int<32> dt = step + 1 - pre_step[pre_id];
+                            weight_delta_t delta = calculate_ltp(dt, config);
+
+                            if (delta != 0) {
+                                weight_update_t update;
+                                update.pre_id = pre_id;
+                                update.post_id = post_id;
+                                update.delta = delta;
+                                update.timestamp = post_event.timestamp;
+
+                                counted_write(weight_updates, update, perf);
+                                total_updates++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    update_count = total_updates;
+    perf_out.write(perf);
+}
+
+// Decoder stage: one output record per frame
+void decode_frames(
+    ap_uint<16> num_frames,
+    hls::stream<frame_control_t> &frame_ctrl,
+    hls::stream<spike_event_t> &spikes_in,
+    hls::stream<ap_uint<32> > &frame_ids,
+    hls::stream<output_data_t> &data_out,
+    ap_uint<32> &frame_count,
+    hls::stream<performance_counter_t> &perf_out
+) {
+    ap_uint<16> spike_counts[MAX_OUTPUT_NEURONS];
+    ap_fixed<16,8> spike_rates[MAX_OUTPUT_NEURONS];
+    #pragma HLS ARRAY_PARTITION variable=spike_counts complete
+    #pragma HLS ARRAY_PARTITION variable=spike_rates complete
+
+    ap_uint<32> total_frames = 0;
+    performance_counter_t perf;
+    perf.reset();
+
+    FRAME_LOOP: for (int f = 0; f < num_frames; f++) {
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        frame_control_t ctrl = counted_read(frame_ctrl, perf);
+
+        // Confidence is relative to the frame length
+        decoder_config_t frame_config = ctrl.decoder;
+        frame_config.window_size = (ctrl.timesteps == 0) ? ap_uint<16>(1) : ctrl.timesteps;
+
+        RESET_LOOP: for (int i = 0; i < MAX_OUTPUT_NEURONS; i++) {
+            #pragma HLS UNROLL
+            spike_counts[i] = 0;
+            spike_rates[i] = 0;
+        }
+
+        STEP_LOOP: for (int t = 0; t < ctrl.timesteps; t++) {
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=100
+            bool step_done = false;
+
+            COUNT_LOOP: while (!step_done) {
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=65
+                spike_event_t spike = counted_read(spikes_in, perf);
+                perf.update(true, false);
+
+                if (spike.neuron_id == SPIKE_STEP_END) {
+                    step_done = true;
+                } else if (spike.neuron_id < MAX_OUTPUT_NEURONS) {
+                    spike_counts[spike.neuron_id]++;
+
+                    ap_fixed<16,8> alpha = frame_config.rate_alpha;
+                    spike_rates[spike.neuron_id] =
+                        alpha * spike_counts[spike.neuron_id] +
+                        (1.0 - alpha) * spike_rates[spike.neuron_id];
+                }
+            }
+        }
+
+        output_data_t output;
+
+        switch (frame_config.decoding_type) {
+            case SPIKE_RATE:
+                decode_spike_rate(spike_rates, frame_config, output);
+                break;
+
+            case FIRST_SPIKE:
+                decode_first_spike(spike_counts, frame_config, output);
+                break;
+
+            default:
+                decode_spike_count(spike_counts, frame_config, output);
+                break;
+        }
+
+        output.frame_id = counted_read(frame_ids, perf);
+        counted_write(data_out, output, perf);
+        total_frames++;
+    }
+
+    frame_count = total_frames;
+    perf_out.write(perf);
+}
+
+// Collect the stage counters into the status block in one write
+void report_status(
+    hls::stream<performance_counter_t> &dispatch_perf,
+    hls::stream<performance_counter_t> &encoder_perf,
+    hls::stream<performance_counter_t> &core_perf,
+    hls::stream<performance_counter_t> &learning_perf,
+    hls::stream<performance_counter_t> &decoder_perf,
+    pipeline_status_t *status_block
+) {
+    pipeline_status_t block;
+    block.dispatch = dispatch_perf.read();
+    block.encoder = encoder_perf.read();
+    block.core = core_perf.read();
+    block.learning = learning_perf.read();
+    block.decoder = decoder_perf.read();
+    *status_block = block;
+}
@@ -12,7 +12,9 @@
 void spike_decoder(
     // Control
     bool enable,
-    decoder_config_t config,
+    spike_time_t timestep,      // Global timestep
+    decoder_config_t shadow_config,
+    ap_uint<8> commit_seq,      // Bump to commit shadow_config
     
     // Input spike stream
     hls::stream<spike_event_t> &spikes_in,
@@ -21,31 +23,59 @@ void spike_decoder(
     hls::stream<output_data_t> &data_out,
     
     // Status
-    ap_uint<32> &status
+    ap_uint<32> &status,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 ) {
     #pragma HLS INTERFACE s_axilite port=enable
-    #pragma HLS INTERFACE s_axilite port=config
+    #pragma HLS INTERFACE ap_none port=timestep
+    #pragma HLS INTERFACE s_axilite port=shadow_config
+    #pragma HLS INTERFACE s_axilite port=commit_seq
     #pragma HLS INTERFACE s_axilite port=status
+    #pragma HLS INTERFACE s_axilite port=active_seq
+    #pragma HLS INTERFACE s_axilite port=perf
     #pragma HLS INTERFACE axis port=spikes_in
     #pragma HLS INTERFACE axis port=data_out
     #pragma HLS INTERFACE s_axilite port=return
     
     static ap_uint<16> spike_counts[MAX_OUTPUT_NEURONS];
     static ap_fixed<16,8> spike_rates[MAX_OUTPUT_NEURONS];
-    static ap_uint<32> window_counter = 0;
+    static spike_time_t window_start = 0;
+    static spike_event_t held_spike;
+    static bool holding = false;
+    static bool window_fresh = true;    // Nothing counted since the last window closed
+    static shadow_config_t<decoder_config_t> config_bank;
+    static performance_counter_t counters = {0, 0, 0, 0, 0};
     
     #pragma HLS ARRAY_PARTITION variable=spike_counts cyclic factor=8
     #pragma HLS ARRAY_PARTITION variable=spike_rates cyclic factor=8
     
+    // A window is decoded entirely under one parameter set
+    config_bank.commit(shadow_config, commit_seq, window_fresh);
+    decoder_config_t config = config_bank.active;
+    active_seq = config_bank.seq;
+    
     if (!enable) {
         status = 0x80000000; // Disabled
+        perf = counters;
         return;
     }
     
-    // Process incoming spikes
-    if (!spikes_in.empty()) {
-        spike_event_t spike = spikes_in.read();
+    window_fresh = false;
+    
+    // Count every spike that is due by the global timestep; the first one
+    // from a later step is held until the timestep reaches it
+    DRAIN_LOOP: for (int i = 0; i < MAX_SPIKES_PER_STEP; i++) {
+        #pragma HLS PIPELINE II=1
+        if (!holding) {
+            holding = counted_read_nb(spikes_in, held_spike, counters);
+        }
+        if (!holding || held_spike.timestamp > timestep) {
+            break;
+        }
+        holding = false;
         
+        spike_event_t spike = held_spike;
         if (spike.neuron_id < MAX_OUTPUT_NEURONS) {
             spike_counts[spike.neuron_id]++;
             
@@ -57,10 +87,10 @@ void spike_decoder(
         }
     }
     
-    // Check if decoding window has elapsed
-    window_counter++;
-    if (window_counter >= config.window_size) {
-        window_counter = 0;
+    // Check if decoding window has elapsed on the global timeline
+    if (timestep - window_start >= config.window_size) {
+        window_start = timestep;
+        window_fresh = true;
         
         output_data_t output;
         
@@ -81,7 +111,7 @@ void spike_decoder(
                 break;
         }
         
-        data_out.write(output);
+        counted_write_once(data_out, output, counters);
         
         // Reset counters for next window
         RESET_LOOP: for (int i = 0; i < MAX_OUTPUT_NEURONS; i++) {
@@ -90,7 +120,8 @@ void spike_decoder(
         }
     }
     
-    status = window_counter;
+    status = timestep - window_start;
+    perf = counters;
 }
 
 // Decode based on spike count
@@ -12,7 +12,9 @@
 void spike_encoder(
     // Control
     bool enable,
-    encoder_config_t config,
+    spike_time_t timestep,      // Global timestep
+    encoder_config_t shadow_config,
+    ap_uint<8> commit_seq,      // Bump to commit shadow_config
     
     // Input data stream
     hls::stream<input_data_t> &data_in,
@@ -21,31 +23,41 @@ void spike_encoder(
     hls::stream<spike_event_t> &spikes_out,
     
     // Status
-    ap_uint<32> &spike_count
+    ap_uint<32> &spike_count,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 ) {
     #pragma HLS INTERFACE s_axilite port=enable
-    #pragma HLS INTERFACE s_axilite port=config
+    #pragma HLS INTERFACE ap_none port=timestep
+    #pragma HLS INTERFACE s_axilite port=shadow_config
+    #pragma HLS INTERFACE s_axilite port=commit_seq
     #pragma HLS INTERFACE s_axilite port=spike_count
+    #pragma HLS INTERFACE s_axilite port=active_seq
+    #pragma HLS INTERFACE s_axilite port=perf
     #pragma HLS INTERFACE axis port=data_in
     #pragma HLS INTERFACE axis port=spikes_out
     #pragma HLS INTERFACE s_axilite port=return
     
-    static ap_uint<32> time_counter = 0;
     static ap_uint<32> total_spikes = 0;
+    static performance_counter_t counters = {0, 0, 0, 0, 0};
+    static shadow_config_t<encoder_config_t> config_bank;
     static ap_uint<16> phase_accumulator[MAX_INPUT_CHANNELS];
     #pragma HLS ARRAY_PARTITION variable=phase_accumulator cyclic factor=16
     
+    // Each call encodes at most one frame, so every call starts on a boundary
+    config_bank.commit(shadow_config, commit_seq, true);
+    encoder_config_t config = config_bank.active;
+    active_seq = config_bank.seq;
+    
     if (!enable) {
         spike_count = total_spikes;
+        perf = counters;
         return;
     }
     
-    // Increment time
-    time_counter++;
-    
     // Process input data
-    if (!data_in.empty()) {
-        input_data_t data = data_in.read();
+    input_data_t data;
+    if (counted_read_nb(data_in, data, counters)) {
         
         // Encode each channel
         ENCODE_LOOP: for (int ch = 0; ch < MAX_INPUT_CHANNELS; ch++) {
@@ -56,16 +68,18 @@ void spike_encoder(
                 
                 switch (config.encoding_type) {
                     case RATE_CODING:
-                        encode_rate(ch, pixel_value, time_counter, config, spikes_out, total_spikes);
+                        encode_rate(ch, pixel_value, timestep, config, spikes_out,
+                                    total_spikes, counters);
                         break;
                         
                     case TEMPORAL_CODING:
-                        encode_temporal(ch, pixel_value, time_counter, config, spikes_out, total_spikes);
+                        encode_temporal(ch, pixel_value, timestep, config, spikes_out,
+                                        total_spikes, counters);
                         break;
                         
                     case PHASE_CODING:
-                        encode_phase(ch, pixel_value, time_counter, config, 
-                                   phase_accumulator[ch], spikes_out, total_spikes);
+                        encode_phase(ch, pixel_value, timestep, config, 
+                                   phase_accumulator[ch], spikes_out, total_spikes, counters);
                         break;
                         
                     default:
@@ -76,6 +90,7 @@ void spike_encoder(
     }
     
     spike_count = total_spikes;
+    perf = counters;
 }
 
 // Rate coding: spike probability proportional to input value
@@ -85,7 +100,8 @@ void encode_rate(
     ap_uint<32> time,
     encoder_config_t config,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_counter
+    ap_uint<32> &spike_counter,
+    performance_counter_t &perf
 ) {
     #pragma HLS INLINE
     
@@ -101,7 +117,7 @@ void encode_rate(
         spike.timestamp = time;
         spike.weight = config.default_weight;
         
-        spikes_out.write(spike);
+        counted_write_once(spikes_out, spike, perf);
         spike_counter++;
     }
 }
@@ -113,7 +129,8 @@ void encode_temporal(
     ap_uint<32> time,
     encoder_config_t config,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_counter
+    ap_uint<32> &spike_counter,
+    performance_counter_t &perf
 ) {
     #pragma HLS INLINE
     
@@ -136,7 +153,7 @@ void encode_temporal(
             spike.timestamp = time;
             spike.weight = config.default_weight;
             
-            spikes_out.write(spike);
+            counted_write_once(spikes_out, spike, perf);
             spike_counter++;
             fired[channel] = true;
         }
@@ -151,7 +168,8 @@ void encode_phase(
     encoder_config_t config,
     ap_uint<16> &phase_acc,
     hls::stream<spike_event_t> &spikes_out,
-    ap_uint<32> &spike_counter
+    ap_uint<32> &spike_counter,
+    performance_counter_t &perf
 ) {
     #pragma HLS INLINE
     
@@ -166,7 +184,7 @@ void encode_phase(
         spike.timestamp = time;
         spike.weight = config.default_weight;
         
-        spikes_out.write(spike);
+        counted_write_once(spikes_out, spike, perf);
         spike_counter++;
         
         phase_acc -= config.phase_threshold;
@@ -13,92 +13,340 @@ void weight_updater(
     // Control
     bool enable,
     bool reset,
+    bool clear_dirty,           // Report the dirty-row bitmap and clear it
+    bool stream_dirty,          // Stream out all dirty rows and clear them
+    spike_time_t global_time,   // Current global timestep (seeds row epochs on reset)
     
     // Weight update input
     hls::stream<weight_update_t> &updates_in,
     
-    // Memory interface
-    weight_t *weight_memory,
+    // Memory interface (packed beats, WEIGHTS_PER_BEAT weights each)
+    weight_beat_t *weight_memory,
     
-    // Configuration
-    weight_config_t config,
+    // Epoch each row was last decayed to, shared with the pipeline's weight reload
+    decay_epoch_t *row_epoch,
+    
+    // CSR index arrays (sparse layout only)
+    const csr_ptr_t *row_ptr,
+    const neuron_id_t *col_idx,
+    
+    // Per-row scale shifts (low-precision modes only)
+    const weight_scale_t row_scale[MAX_NEURONS],
+    
+    // Configuration (shadow copy, committed when commit_seq changes)
+    weight_config_t shadow_config,
+    ap_uint<8> commit_seq,
+    
+    // Dirty-row readback
+    hls::stream<weight_row_beat_t> &dirty_out,
     
     // Status
-    ap_uint<32> &updates_applied
+    ap_uint<32> &updates_applied,
+    dirty_bitmap_t &dirty_bitmap,
+    ap_uint<8> &active_seq,
+    performance_counter_t &perf
 ) {
     #pragma HLS INTERFACE s_axilite port=enable
     #pragma HLS INTERFACE s_axilite port=reset
-    #pragma HLS INTERFACE s_axilite port=config
+    #pragma HLS INTERFACE s_axilite port=clear_dirty
+    #pragma HLS INTERFACE s_axilite port=stream_dirty
+    #pragma HLS INTERFACE ap_none port=global_time
+    #pragma HLS INTERFACE s_axilite port=row_scale
+    #pragma HLS INTERFACE s_axilite port=shadow_config
+    #pragma HLS INTERFACE s_axilite port=commit_seq
+    #pragma HLS INTERFACE s_axilite port=active_seq
     #pragma HLS INTERFACE s_axilite port=updates_applied
+    #pragma HLS INTERFACE s_axilite port=dirty_bitmap
+    #pragma HLS INTERFACE s_axilite port=perf
     #pragma HLS INTERFACE axis port=updates_in
-    #pragma HLS INTERFACE m_axi port=weight_memory offset=slave depth=65536
+    #pragma HLS INTERFACE axis port=dirty_out
+    #pragma HLS INTERFACE m_axi port=weight_memory offset=slave depth=8192 max_read_burst_length=16 max_write_burst_length=16
+    #pragma HLS INTERFACE m_axi port=row_epoch offset=slave bundle=epoch depth=64
+    #pragma HLS INTERFACE m_axi port=row_ptr offset=slave bundle=csr depth=65
+    #pragma HLS INTERFACE m_axi port=col_idx offset=slave bundle=csr depth=4096
     #pragma HLS INTERFACE s_axilite port=return
     
     static ap_uint<32> update_counter = 0;
+    static dirty_bitmap_t dirty_rows = 0;
+    static performance_counter_t counters = {0, 0, 0, 0, 0};
+    static ap_uint<16> round_lfsr = 0xACE1;     // Stochastic rounding state
+    
+    // Lazy decay state: retention powers for the active decay rate
+    static decay_factor_t decay_pow[DECAY_POW_BITS];
+    static ap_uint<8> table_rate = 0;
+    static bool table_valid = false;
+    static shadow_config_t<weight_config_t> config_bank;
+    
+    #pragma HLS ARRAY_PARTITION variable=decay_pow complete
     
     if (reset) {
+        config_bank.reset();
+    }
+    
+    // Each call applies one batch of updates, so every call starts on a boundary
+    config_bank.commit(shadow_config, commit_seq, true);
+    weight_config_t config = config_bank.active;
+    active_seq = config_bank.seq;
+    
+    if (reset) {
+        // Weights loaded at reset owe no decay for the time before it
+        decay_epoch_t reset_epoch = global_time >> config.decay_epoch_shift;
+        EPOCH_RESET_LOOP: for (int i = 0; i < MAX_NEURONS; i++) {
+            #pragma HLS PIPELINE II=1
+            row_epoch[i] = reset_epoch;
+        }
+        table_valid = false;
+        round_lfsr = 0xACE1;
         update_counter = 0;
+        dirty_rows = 0;
+        counters.reset();
         updates_applied = 0;
+        dirty_bitmap = 0;
+        perf = counters;
+        return;
+    }
+    
+    // Incremental readback: only rows touched since the last one
+    if (stream_dirty) {
+        stream_dirty_rows(weight_memory, row_ptr, config.sparse, dirty_rows, dirty_out,
+                          counters);
+        dirty_bitmap = dirty_rows;
+        dirty_rows = 0;
+        updates_applied = update_counter;
+        perf = counters;
         return;
     }
     
     if (!enable) {
         updates_applied = update_counter;
+        dirty_bitmap = dirty_rows;
+        if (clear_dirty) dirty_rows = 0;
+        perf = counters;
         return;
     }
     
     // Process weight updates
-    if (!updates_in.empty()) {
-        weight_update_t update = updates_in.read();
+    weight_update_t update;
+    if (counted_read_nb(updates_in, update, counters)) {
         
-        // Calculate memory address
-        ap_uint<32> addr = (update.pre_id * MAX_NEURONS) + update.post_id;
+        neuron_id_t row = update.pre_id;
+        ap_uint<32> addr = 0;
+        ap_uint<32> row_first = 0;
+        ap_uint<32> row_last = 0;
+        bool valid = false;
         
-        if (addr < MAX_SYNAPSES) {
-            // Read current weight
-            weight_t current_weight = weight_memory[addr];
-            
-            // Apply update with bounds checking
-            ap_int<16> new_weight = current_weight + update.delta;
+        if (config.sparse) {
+            // Locate the synapse slot inside its CSR row
+            if (row < MAX_NEURONS) {
+                row_first = row_ptr[row];
+                row_last = row_ptr[row + 1];
+                csr_ptr_t slot = 0;
+                valid = find_synapse(col_idx, row_first, row_last, update.post_id, slot);
+                addr = slot;
+            }
+        } else {
+            // Calculate memory address
+            addr = (update.pre_id * MAX_NEURONS) + update.post_id;
+            row_first = update.pre_id * MAX_NEURONS;
+            row_last = row_first + MAX_NEURONS;
+            valid = addr < MAX_SYNAPSES;
+        }
+        
+        if (valid) {
+            decay_epoch_t epoch = update.timestamp >> config.decay_epoch_shift;
             
-            // Apply weight bounds
-            if (new_weight > config.max_weight) {
-                new_weight = config.max_weight;
-            } else if (new_weight < config.min_weight) {
-                new_weight = config.min_weight;
+            // Bring the whole row up to date for the epochs it sat untouched
+            // (the pipeline applies the same owed decay on reload until then)
+            decay_elapsed_t elapsed = owed_epochs(epoch, row_epoch[row]);
+            if (config.enable_decay && elapsed != 0) {
+                if (!table_valid || table_rate != config.decay_rate) {
+                    build_decay_table(config.decay_rate, decay_pow);
+                    table_rate = config.decay_rate;
+                    table_valid = true;
+                }
+                
+                decay_row(weight_memory, row_first, row_last,
+                          decay_factor(elapsed, decay_pow));
+            }
+            if (epoch > row_epoch[row]) {
+                row_epoch[row] = epoch;
             }
+            dirty_rows[row] = 1;
+            
+            // Read the beat holding the current weight
+            ap_uint<32> beat_addr = addr / WEIGHTS_PER_BEAT;
+            int lane = addr % WEIGHTS_PER_BEAT;
+            weight_beat_t beat = weight_memory[beat_addr];
+            weight_code_t current_code = weight_lane_get(beat, lane);
+            
+#if WEIGHT_PRECISION == WEIGHT_PRECISION_INT8
+            (void)row_scale;
+            weight_scale_t shift = 0;
+#else
+            weight_scale_t shift = row_scale[row];
+#endif
             
-            // Apply weight decay if enabled
-            if (config.enable_decay) {
-                new_weight = apply_decay(new_weight, config.decay_rate);
+            // Apply update in code units with bounds checking
+            ap_int<16> new_code = current_code + quantize_delta(update.delta, shift, round_lfsr);
+            
+            // Apply weight bounds (configured bounds are in weight units)
+            ap_int<16> max_code = config.max_weight >> shift;
+            ap_int<16> min_code = config.min_weight >> shift;
+            if (max_code > WEIGHT_CODE_MAX) max_code = WEIGHT_CODE_MAX;
+            if (min_code < WEIGHT_CODE_MIN) min_code = WEIGHT_CODE_MIN;
+            
+            if (new_code > max_code) {
+                new_code = max_code;
+            } else if (new_code < min_code) {
+                new_code = min_code;
             }
             
-            // Write back updated weight
-            weight_memory[addr] = new_weight;
+            // Write back updated weight, leaving the other lanes untouched
+            weight_memory[beat_addr] = weight_lane_set(beat, lane, new_code);
             update_counter++;
         }
     }
     
     updates_applied = update_counter;
+    dirty_bitmap = dirty_rows;
+    if (clear_dirty) dirty_rows = 0;
+    perf = counters;
+}
+
+// Scale a weight code towards zero by a Q0.16 retention factor
+weight_code_t apply_decay(weight_code_t code, decay_factor_t factor) {
+    #pragma HLS INLINE
+    
+    if (code == 0) return 0;
+    
+    ap_uint<WEIGHT_CODE_BITS> magnitude = (code < 0) ? ap_uint<WEIGHT_CODE_BITS>(-code)
+                                                     : ap_uint<WEIGHT_CODE_BITS>(code);
+    ap_uint<WEIGHT_CODE_BITS + DECAY_FRAC_BITS + 1> scaled = magnitude * factor;
+    ap_int<WEIGHT_CODE_BITS + 1> decayed = scaled >> DECAY_FRAC_BITS;
+    
+    return (code < 0) ? weight_code_t(-decayed) : weight_code_t(decayed);
+}
+
+// Convert a weight delta into code units, rounding stochastically so that
+// sub-step deltas still move low-precision weights in expectation. The
+// caller owns the LFSR state, so every inlined copy shares one sequence.
+ap_int<16> quantize_delta(weight_delta_t delta, weight_scale_t shift, ap_uint<16> &lfsr) {
+    #pragma HLS INLINE
+    
+    if (shift == 0) return delta;
+    
+    ap_int<16> steps = delta >> shift;                  // Floor in code units
+    ap_uint<16> mask = (ap_uint<16>(1) << shift) - 1;
+    ap_uint<16> remainder = delta & mask;
+    
+    bool bit = ((lfsr >> 0) ^ (lfsr >> 2) ^ (lfsr >> 3) ^ (lfsr >> 5)) & 1;
+    lfsr = (lfsr >> 1) | (ap_uint<16>(bit) << 15);
+    
+    if ((lfsr & mask) < remainder) {
+        steps++;
+    }
+    
+    return steps;
 }
 
-// Apply exponential weight decay
-weight_t apply_decay(weight_t weight, ap_uint<8> decay_rate) {
+// Precompute retention^(2^i) so any elapsed epoch count needs one multiply per set bit
+void build_decay_table(ap_uint<8> decay_rate, decay_factor_t table[DECAY_POW_BITS]) {
+    #pragma HLS INLINE off
+    
+    ap_uint<2 * (DECAY_FRAC_BITS + 1)> power = (ap_uint<DECAY_FRAC_BITS + 1>(decay_rate) + 1) << 8;
+    
+    TABLE_LOOP: for (int i = 0; i < DECAY_POW_BITS; i++) {
+        #pragma HLS PIPELINE II=1
+        table[i] = power;
+        power = (power * power) >> DECAY_FRAC_BITS;
+    }
+}
+
+// Accumulated retention factor for a number of elapsed epochs
+decay_factor_t decay_factor(decay_elapsed_t elapsed, const decay_factor_t table[DECAY_POW_BITS]) {
     #pragma HLS INLINE
     
-    if (weight == 0) return 0;
+    ap_uint<2 * (DECAY_FRAC_BITS + 1)> factor = 1 << DECAY_FRAC_BITS;
+    
+    FACTOR_LOOP: for (int i = 0; i < DECAY_POW_BITS; i++) {
+        #pragma HLS UNROLL
+        if (elapsed[i]) {
+            factor = (factor * table[i]) >> DECAY_FRAC_BITS;
+        }
+    }
+    
+    return factor;
+}
+
+// Apply an accumulated decay factor to the weights of one row, [first, last)
+void decay_row(weight_beat_t *weight_memory, ap_uint<32> first, ap_uint<32> last, decay_factor_t factor) {
+    #pragma HLS INLINE off
+    
+    ap_uint<32> first_beat = first / WEIGHTS_PER_BEAT;
+    ap_uint<32> last_beat = (last + WEIGHTS_PER_BEAT - 1) / WEIGHTS_PER_BEAT;
     
-    // Decay towards zero
-    ap_int<16> decayed = weight;
-    ap_int<16> decay_amount = (weight * decay_rate) >> 8;
+    DECAY_ROW_LOOP: for (ap_uint<32> b = first_beat; b < last_beat; b++) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=BEATS_PER_ROW
+        weight_beat_t beat = weight_memory[b];
+        
+        DECAY_LANE_LOOP: for (int lane = 0; lane < WEIGHTS_PER_BEAT; lane++) {
+            #pragma HLS UNROLL
+            ap_uint<32> idx = b * WEIGHTS_PER_BEAT + lane;
+            if (idx >= first && idx < last) {
+                beat = weight_lane_set(beat, lane, apply_decay(weight_lane_get(beat, lane), factor));
+            }
+        }
+        
+        weight_memory[b] = beat;
+    }
+}
+
+// Emit every beat of each dirty row as a (row, beat, data) record
+void stream_dirty_rows(const weight_beat_t *weight_memory, const csr_ptr_t *row_ptr,
+                       bool sparse, dirty_bitmap_t dirty,
+                       hls::stream<weight_row_beat_t> &dirty_out,
+                       performance_counter_t &perf) {
+    #pragma HLS INLINE off
     
-    if (weight > 0) {
-        decayed = weight - decay_amount;
-        if (decayed < 0) decayed = 0;
-    } else {
-        decayed = weight + decay_amount;
-        if (decayed > 0) decayed = 0;
+    DIRTY_ROW_LOOP: for (int row = 0; row < MAX_NEURONS; row++) {
+        if (!dirty[row]) continue;
+        
+        ap_uint<32> first = sparse ? ap_uint<32>(row_ptr[row]) : ap_uint<32>(row * MAX_NEURONS);
+        ap_uint<32> last = sparse ? ap_uint<32>(row_ptr[row + 1]) : ap_uint<32>(first + MAX_NEURONS);
+        if (first == last) continue;
+        
+        ap_uint<32> first_beat = first / WEIGHTS_PER_BEAT;
+        ap_uint<32> last_beat = (last + WEIGHTS_PER_BEAT - 1) / WEIGHTS_PER_BEAT;
+        
+        DIRTY_BEAT_LOOP: for (ap_uint<32> b = first_beat; b < last_beat; b++) {
+            #pragma HLS PIPELINE II=1
+            #pragma HLS LOOP_TRIPCOUNT min=1 max=BEATS_PER_ROW
+            weight_row_beat_t record;
+            record.row = row;
+            record.beat = b;
+            record.data = weight_memory[b];
+            record.last = (b == last_beat - 1);
+            counted_write_once(dirty_out, record, perf);
+        }
+    }
+}
+
+// Find the slot of (pre, post) with a burst scan over the row's column ids
+bool find_synapse(const neuron_id_t *col_idx, csr_ptr_t row_begin, csr_ptr_t row_end,
+                  neuron_id_t post, csr_ptr_t &slot) {
+    #pragma HLS INLINE off
+    
+    bool found = false;
+    
+    ROW_SEARCH_LOOP: for (csr_ptr_t i = row_begin; i < row_end; i++) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=1 max=MAX_NEURONS
+        if (!found && col_idx[i] == post) {
+            slot = i;
+            found = true;
+        }
     }
     
-    return decayed;
+    return found;
 }
@@ -61,6 +61,14 @@ run_test "Weight Updater" tb_weight
 g++ -std=c++11 -I../include tb_spike_decoder.cpp -o tb_decoder
 run_test "Spike Decoder" tb_decoder
 
+# Network Controller Test
+g++ -std=c++11 -I../include tb_network_controller.cpp -o tb_controller
+run_test "Network Controller" tb_controller
+
+# End-to-end Pipeline Test
+g++ -std=c++11 -I../include tb_snn_pipeline.cpp -o tb_pipeline
+run_test "SNN Pipeline" tb_pipeline
+
 # Summary
 echo ""
 echo "======================================"
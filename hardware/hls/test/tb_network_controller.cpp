@@ -0,0 +1,352 @@
+//-----------------------------------------------------------------------------
+// Title         : Testbench for Network Controller
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : tb_network_controller.cpp
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Tests the job descriptor ring and context bank
+//-----------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include "../include/network_controller.h"
+#include "test_utils.h"
+
+using namespace std;
+
+const int RING_SIZE = 8;
+
+// DDR buffers shared with the controller
+static job_descriptor_t job_ring[RING_SIZE];
+static job_completion_t completions[RING_SIZE];
+static input_data_t frame_memory[RING_SIZE];
+static output_data_t result_memory[RING_SIZE];
+
+// Controller streams
+static hls::stream<input_data_t> input_data;
+static hls::stream<output_data_t> output_data;
+static hls::stream<input_data_t> encoder_data;
+static hls::stream<frame_control_t> frame_ctrl;
+static hls::stream<control_packet_t> encoder_ctrl;
+static hls::stream<control_packet_t> learning_ctrl;
+static hls::stream<control_packet_t> decoder_ctrl;
+static hls::stream<output_data_t> decoder_results;
+
+// Controller outputs
+static ap_uint<16> ring_head;
+static spike_time_t timestep;
+static network_status_t status;
+
+void run_command(network_command_t command, ap_uint<16> ring_tail,
+                 const network_context_t &context, ap_uint<8> context_id) {
+    network_config_t config;
+    config.mode = MODE_INFERENCE;
+    config.encoding_type = RATE_CODING;
+    config.decoding_type = SPIKE_COUNT;
+    config.batch_size = 1;
+    config.input_scale = 1;
+    config.learning_rate = 1;
+    config.stdp_window = 20;
+    config.enable_monitoring = false;
+
+    network_controller(command, config, input_data, output_data, encoder_data, frame_ctrl,
+                       encoder_ctrl, learning_ctrl, decoder_ctrl, decoder_results,
+                       context, context_id,
+                       job_ring, frame_memory, result_memory, completions,
+                       RING_SIZE, ring_tail, ring_head, timestep, status);
+}
+
+void run_command(network_command_t command, ap_uint<16> ring_tail) {
+    network_context_t context = network_context_t();
+    run_command(command, ring_tail, context, 0);
+}
+
+// Queue a job in ring slot idx; its frame and result buffers share the index
+void make_job(int idx, int job_id, int timesteps, int mode, int context_id) {
+    job_ring[idx].job_id = job_id;
+    job_ring[idx].input_addr = idx;
+    job_ring[idx].output_addr = idx;
+    job_ring[idx].timesteps = timesteps;
+    job_ring[idx].mode = mode;
+    job_ring[idx].context_id = context_id;
+
+    for (int i = 0; i < MAX_INPUT_CHANNELS; i++) {
+        frame_memory[idx].pixels[i] = 0;
+    }
+    frame_memory[idx].label = job_id % MAX_OUTPUT_NEURONS;
+    frame_memory[idx].frame_id = 1000 + job_id;
+}
+
+// Decoder result for a job's frame, as the downstream pipeline would produce.
+// The C model blocks on decoder_results, so results are queued up front.
+void queue_result(int job_id) {
+    output_data_t result;
+    result.class_id = job_id % MAX_OUTPUT_NEURONS;
+    result.confidence = 200;
+    for (int i = 0; i < MAX_OUTPUT_NEURONS; i++) {
+        result.values[i] = (i == result.class_id) ? 10 : 0;
+    }
+    result.frame_id = 1000 + job_id;
+    decoder_results.write(result);
+}
+
+// Context with its own weight base and encoder/decoder parameters
+network_context_t make_context(int weight_base, int channels, int outputs) {
+    network_context_t context = network_context_t();
+    context.encoder.encoding_type = RATE_CODING;
+    context.encoder.num_channels = channels;
+    context.encoder.time_window = 20;
+    context.decoder.decoding_type = SPIKE_COUNT;
+    context.decoder.num_outputs = outputs;
+    context.weight_base = weight_base;
+    return context;
+}
+
+// Frame control matches the job's timesteps and the context's parameters
+bool control_matches(const frame_control_t &ctrl, int timesteps, int context_id,
+                     const network_context_t &context) {
+    return ctrl.timesteps == timesteps && ctrl.context_id == context_id &&
+           ctrl.weight_base == context.weight_base &&
+           ctrl.encoder.num_channels == context.encoder.num_channels &&
+           ctrl.decoder.num_outputs == context.decoder.num_outputs;
+}
+
+// Completion in ring slot idx matches job job_id with a decoded result
+bool completion_ok(int idx, int job_id) {
+    const job_completion_t &done = completions[idx];
+    return done.job_id == job_id && done.status == JOB_STATUS_DONE &&
+           done.frame_id == 1000 + job_id && done.class_id == job_id % MAX_OUTPUT_NEURONS &&
+           result_memory[idx].frame_id == 1000 + job_id;
+}
+
+int main() {
+    cout << "==============================================\n";
+    cout << "Network Controller Testbench\n";
+    cout << "==============================================\n";
+
+    int total_errors = 0;
+
+    run_command(CMD_RESET, 0);
+
+    network_context_t context = make_context(0, MAX_NEURONS, MAX_OUTPUT_NEURONS);
+    run_command(CMD_STORE_CONTEXT, 0, context, 0);
+
+    //-------------------------------------------------------------------------
+    // Test 1: Job Submission
+    //-------------------------------------------------------------------------
+    cout << "\nTest 1: Job Submission\n";
+    cout << "----------------------------------------\n";
+
+    const int submit_steps[3] = {10, 5, 20};
+    const int submit_modes[3] = {MODE_INFERENCE, MODE_TRAINING, MODE_INFERENCE};
+    for (int j = 0; j < 3; j++) {
+        make_job(j, j, submit_steps[j], submit_modes[j], 0);
+        queue_result(j);
+    }
+    run_command(CMD_RUN_RING, 3);
+
+    // Every frame goes out with its own control, on a contiguous timeline
+    bool submit_ok = true;
+    int start = 0;
+    for (int j = 0; j < 3; j++) {
+        if (encoder_data.empty() || frame_ctrl.empty()) {
+            submit_ok = false;
+            break;
+        }
+        input_data_t frame = encoder_data.read();
+        frame_control_t ctrl = frame_ctrl.read();
+        submit_ok &= frame.frame_id == 1000 + j && ctrl.start_time == start &&
+                     ctrl.timesteps == submit_steps[j] && ctrl.mode == submit_modes[j];
+        start += submit_steps[j];
+    }
+    submit_ok &= encoder_data.empty() && frame_ctrl.empty();
+
+    cout << "Head: " << ring_head << ", timestep: " << timestep << "\n";
+
+    if (submit_ok && ring_head == 3 && timestep == start) {
+        cout << "PASS: Jobs issued in order with their timesteps and mode\n";
+    } else {
+        cout << "FAIL: Issued frames or frame control out of order\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 2: Completion Write-Back
+    //-------------------------------------------------------------------------
+    cout << "\nTest 2: Completion Write-Back\n";
+    cout << "----------------------------------------\n";
+
+    bool written_back = decoder_results.empty();
+    for (int j = 0; j < 3; j++) {
+        written_back &= completion_ok(j, j);
+    }
+
+    if (written_back && status.batches_processed == 3 && status.errors == 0) {
+        cout << "PASS: One completion and one result per job\n";
+    } else {
+        cout << "FAIL: Completions or results missing\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 3: Full Ring
+    //-------------------------------------------------------------------------
+    cout << "\nTest 3: Full Ring\n";
+    cout << "----------------------------------------\n";
+
+    // Head is at 3: seven entries fill the ring, wrapping to a tail of 2
+    for (int n = 0; n < RING_SIZE - 1; n++) {
+        int idx = (3 + n) % RING_SIZE;
+        make_job(idx, 10 + n, 4, MODE_INFERENCE, 0);
+        queue_result(10 + n);
+    }
+    run_command(CMD_RUN_RING, 2);
+
+    bool ring_ok = true;
+    for (int n = 0; n < RING_SIZE - 1; n++) {
+        ring_ok &= completion_ok((3 + n) % RING_SIZE, 10 + n);
+    }
+    int frames_issued = 0;
+    while (!encoder_data.empty()) {
+        encoder_data.read();
+        frame_ctrl.read();
+        frames_issued++;
+    }
+
+    // A tail outside the ring is rejected without moving the head
+    run_command(CMD_RUN_RING, RING_SIZE);
+
+    cout << "Head: " << ring_head << ", frames issued: " << frames_issued << "\n";
+
+    if (ring_ok && frames_issued == RING_SIZE - 1 && ring_head == 2 &&
+        status.batches_processed == 3 + RING_SIZE - 1 && status.errors == 1) {
+        cout << "PASS: Full ring drained across the wrap\n";
+    } else {
+        cout << "FAIL: Full ring not drained\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 4: Two Jobs in Flight
+    //-------------------------------------------------------------------------
+    cout << "\nTest 4: Two Jobs in Flight\n";
+    cout << "----------------------------------------\n";
+
+    // Each result retires the job issued JOBS_IN_FLIGHT slots earlier; a job
+    // naming an empty context shares the window but never reaches the datapath
+    make_job(2, 20, 8, MODE_INFERENCE, 0);
+    make_job(3, 21, 8, MODE_INFERENCE, 3);
+    make_job(4, 22, 8, MODE_INFERENCE, 0);
+    make_job(5, 23, 8, MODE_INFERENCE, 0);
+    queue_result(20);
+    queue_result(22);
+    queue_result(23);
+    run_command(CMD_RUN_RING, 6);
+
+    frames_issued = 0;
+    while (!encoder_data.empty()) {
+        encoder_data.read();
+        frame_ctrl.read();
+        frames_issued++;
+    }
+
+    bool in_flight_ok = completion_ok(2, 20) && completion_ok(4, 22) && completion_ok(5, 23) &&
+                        completions[3].job_id == 21 &&
+                        completions[3].status == JOB_STATUS_BAD_CONTEXT;
+
+    if (in_flight_ok && frames_issued == 3 && decoder_results.empty() && ring_head == 6) {
+        cout << "PASS: Results matched to their jobs across the in-flight window\n";
+    } else {
+        cout << "FAIL: In-flight results matched to the wrong jobs\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 5: Context Store
+    //-------------------------------------------------------------------------
+    cout << "\nTest 5: Context Store\n";
+    cout << "----------------------------------------\n";
+
+    network_context_t context_b = make_context(0x400, MAX_NEURONS / 2, 5);
+    int errors_before = status.errors;
+    run_command(CMD_STORE_CONTEXT, 0, context_b, 2);
+    bool stored = status.contexts_valid == 0x5 && status.errors == errors_before;
+
+    // Slots past the bank are rejected and leave it untouched
+    run_command(CMD_STORE_CONTEXT, 0, context_b, MAX_CONTEXTS);
+    bool rejected = status.contexts_valid == 0x5 && status.errors == errors_before + 1;
+
+    cout << "Valid contexts: 0x" << hex << status.contexts_valid << dec << "\n";
+
+    if (stored && rejected) {
+        cout << "PASS: Context stored in its slot, out-of-range slot rejected\n";
+    } else {
+        cout << "FAIL: Context bank not updated as commanded\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 6: Back-to-Back Jobs with Different Contexts
+    //-------------------------------------------------------------------------
+    cout << "\nTest 6: Back-to-Back Jobs with Different Contexts\n";
+    cout << "----------------------------------------\n";
+
+    // Each frame carries its own job's context, including a slot rewritten
+    // between runs
+    make_job(6, 30, 12, MODE_INFERENCE, 0);
+    make_job(7, 31, 6, MODE_INFERENCE, 2);
+    make_job(0, 32, 9, MODE_INFERENCE, 0);
+    for (int j = 30; j < 33; j++) {
+        queue_result(j);
+    }
+    run_command(CMD_RUN_RING, 1);
+
+    frame_control_t ctx_ctrl[3];
+    bool contexts_ok = true;
+    for (int j = 0; j < 3; j++) {
+        contexts_ok &= !frame_ctrl.empty();
+        if (contexts_ok) {
+            ctx_ctrl[j] = frame_ctrl.read();
+            encoder_data.read();
+        }
+    }
+    contexts_ok = contexts_ok && control_matches(ctx_ctrl[0], 12, 0, context) &&
+                  control_matches(ctx_ctrl[1], 6, 2, context_b) &&
+                  control_matches(ctx_ctrl[2], 9, 0, context) && status.context_id == 0;
+
+    network_context_t context_c = make_context(0x800, MAX_NEURONS, 8);
+    run_command(CMD_STORE_CONTEXT, 0, context_c, 0);
+    make_job(1, 33, 4, MODE_INFERENCE, 0);
+    queue_result(33);
+    run_command(CMD_RUN_RING, 2);
+    contexts_ok = contexts_ok && !frame_ctrl.empty() &&
+                  control_matches(frame_ctrl.read(), 4, 0, context_c);
+    encoder_data.read();
+
+    bool ctx_done = completion_ok(6, 30) && completion_ok(7, 31) &&
+                    completion_ok(0, 32) && completion_ok(1, 33);
+
+    if (contexts_ok && ctx_done && ring_head == 2) {
+        cout << "PASS: Every frame went out with its job's context\n";
+    } else {
+        cout << "FAIL: Frame control did not follow the job contexts\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test Summary
+    //-------------------------------------------------------------------------
+    cout << "\n==============================================\n";
+    cout << "Test Summary\n";
+    cout << "==============================================\n";
+    cout << "Total Tests: 6\n";
+    cout << "Errors: " << total_errors << "\n";
+
+    if (total_errors == 0) {
+        cout << "\nALL TESTS PASSED!\n";
+        return 0;
+    } else {
+        cout << "\nTEST FAILED with " << total_errors << " errors\n";
+        return 1;
+    }
+}
@@ -87,6 +87,13 @@ int main() {
     bool reset = false;
     ap_uint<32> status;
     
+    // Global timestep, held past every test spike so each call drains its batch
+    spike_time_t now = 10000;
+    int config_seq = 0;            // Bumped whenever the test changes config
+    ap_uint<8> active_seq;
+    performance_counter_t perf;
+    static ap_uint<32> ckpt_memory[CKPT_WORDS];
+    
     int total_errors = 0;
     
     //-------------------------------------------------------------------------
@@ -96,8 +103,8 @@ int main() {
     cout << "----------------------------------------\n";
     
     reset = true;
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     reset = false;
     
     if (status == 0) {
@@ -124,8 +131,8 @@ int main() {
     pre_spikes.write(pre_spike);
     
     // Process pre spike
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     // Post spike at t=120 (dt = 20)
     spike_event_t post_spike;
@@ -135,8 +142,8 @@ int main() {
     post_spikes.write(post_spike);
     
     // Process post spike
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     // Check weight update
     if (!weight_updates.empty()) {
@@ -168,8 +175,8 @@ int main() {
     post_spikes.write(post_spike);
     
     // Process post spike
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     // Pre spike at t=230 (dt = 30)
     pre_spike.neuron_id = 3;
@@ -177,8 +184,8 @@ int main() {
     pre_spikes.write(pre_spike);
     
     // Process pre spike
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     // Check weight update
     if (!weight_updates.empty()) {
@@ -209,16 +216,16 @@ int main() {
     pre_spike.timestamp = 300;
     pre_spikes.write(pre_spike);
     
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     // Post spike outside window (t=450, dt=150 > 100)
     post_spike.neuron_id = 5;
     post_spike.timestamp = 450;
     post_spikes.write(post_spike);
     
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     if (weight_updates.empty()) {
         cout << "PASS: No update outside STDP window\n";
@@ -236,8 +243,8 @@ int main() {
     // Clear streams and reset
     while (!weight_updates.empty()) weight_updates.read();
     reset = true;
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     reset = false;
     
     // Generate multiple pre spikes
@@ -249,8 +256,8 @@ int main() {
     
     // Process all pre spikes
     for (int i = 0; i < 5; i++) {
-        snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                           weight_updates, status);
+        snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                           weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     }
     
     // Generate post spike that should pair with all pre spikes
@@ -258,8 +265,8 @@ int main() {
     post_spike.timestamp = 560;
     post_spikes.write(post_spike);
     
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     // Count updates
     int update_count = 0;
@@ -290,8 +297,8 @@ int main() {
     pre_spike.timestamp = 700;
     pre_spikes.write(pre_spike);
     
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     
     if ((status & 0x80000000) != 0) {
         cout << "PASS: Disabled flag set in status\n";
@@ -308,8 +315,8 @@ int main() {
     
     enable = true;
     reset = true;
-    snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                       weight_updates, status);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     reset = false;
     
     // Generate burst of activity
@@ -332,8 +339,8 @@ int main() {
         }
         
         // Process
-        snn_learning_engine(enable, reset, config, pre_spikes, post_spikes, 
-                           weight_updates, status);
+        snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                           weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
     }
     
     timer.stop();
@@ -349,14 +356,116 @@ int main() {
     cout << "Generated " << total_updates << " weight updates\n";
     cout << "Status counter: " << status << "\n";
     
+    //-------------------------------------------------------------------------
+    // Test 8: Checkpoint and Restore
+    //-------------------------------------------------------------------------
+    cout << "\nTest 8: Checkpoint and Restore\n";
+    cout << "----------------------------------------\n";
+    
+    // Amplitude large enough for a non-zero 8-bit delta
+    config.a_plus = 0.1;
+    config_seq++;
+    
+    while (!weight_updates.empty()) weight_updates.read();
+    reset = true;
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    reset = false;
+    
+    // Learning job records a pre spike, then is checkpointed
+    pre_spike.neuron_id = 6;
+    pre_spike.timestamp = 900;
+    pre_spikes.write(pre_spike);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_SAVE, ckpt_memory, status, active_seq, perf);
+    
+    // Preempting job wipes the STDP tables
+    reset = true;
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    reset = false;
+    
+    // Resumed job pairs its next post spike with the saved pre spike
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_RESTORE, ckpt_memory, status, active_seq, perf);
+    post_spike.neuron_id = 7;
+    post_spike.timestamp = 910;
+    post_spikes.write(post_spike);
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    
+    if (!weight_updates.empty() &&
+        verify_stdp_update(weight_updates.read(), 6, 7, true) && weight_updates.empty()) {
+        cout << "PASS: Restored spike times produced the LTP update\n";
+    } else {
+        cout << "FAIL: Restored state did not pair 6 -> 7\n";
+        total_errors++;
+    }
+    
+    //-------------------------------------------------------------------------
+    // Test 9: Spikes Held Until Their Timestep
+    //-------------------------------------------------------------------------
+    cout << "\nTest 9: Spikes Held Until Their Timestep\n";
+    cout << "----------------------------------------\n";
+    
+    while (!weight_updates.empty()) weight_updates.read();
+    reset = true;
+    snn_learning_engine(enable, reset, now, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    reset = false;
+    
+    // Post spike stamped ahead of the global timestep is held back
+    pre_spike.neuron_id = 8;
+    pre_spike.timestamp = 1000;
+    pre_spikes.write(pre_spike);
+    post_spike.neuron_id = 9;
+    post_spike.timestamp = 1005;
+    post_spikes.write(post_spike);
+    snn_learning_engine(enable, reset, 1002, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    bool held_early = weight_updates.empty() && post_spikes.empty();
+    
+    // A pre spike due before the held post still goes first
+    pre_spike.neuron_id = 10;
+    pre_spike.timestamp = 1003;
+    pre_spikes.write(pre_spike);
+    snn_learning_engine(enable, reset, 1004, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    bool held_later = weight_updates.empty();
+    
+    // Released once the timestep reaches it: LTP from both pre spikes
+    snn_learning_engine(enable, reset, 1005, config, config_seq, pre_spikes, post_spikes, 
+                       weight_updates, CKPT_NONE, ckpt_memory, status, active_seq, perf);
+    int released = 0;
+    bool released_ok = true;
+    while (!weight_updates.empty()) {
+        weight_update_t update = weight_updates.read();
+        released_ok &= update.post_id == 9 && update.delta > 0 && update.timestamp == 1005 &&
+                       (update.pre_id == 8 || update.pre_id == 10);
+        released++;
+    }
+    
+    if (held_early && held_later && released == 2 && released_ok) {
+        cout << "PASS: Post spike held until timestep 1005, then paired with both pre spikes\n";
+    } else {
+        cout << "FAIL: Held " << (held_early && held_later ? "yes" : "no")
+             << ", released " << released << " updates\n";
+        total_errors++;
+    }
+    
+    config.a_plus = 0.01;
+    config_seq++;
+    
     //-------------------------------------------------------------------------
     // Test Summary
     //-------------------------------------------------------------------------
     cout << "\n==============================================\n";
     cout << "Test Summary\n";
     cout << "==============================================\n";
-    cout << "Total Tests: 7\n";
-    cout << "Passed: " << (7 - (total_errors > 0 ? 1 : 0)) << "\n";
+    cout << "Total Tests: 9\n";
+    cout << "Passed: " << (9 - (total_errors > 0 ? 1 : 0)) << "\n";
     cout << "Failed: " << (total_errors > 0 ? 1 : 0) << "\n";
     
     if (total_errors == 0) {
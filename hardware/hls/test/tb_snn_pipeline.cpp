@@ -0,0 +1,450 @@
+//-----------------------------------------------------------------------------
+// Title         : Testbench for SNN Pipeline
+// Project       : PYNQ-Z2 SNN Accelerator
+// File          : tb_snn_pipeline.cpp
+// Author        : Jiwoon Lee (@metr0jw)
+// Organization  : Kwangwoon University, Seoul, South Korea
+// Description   : Tests frames end to end through the DATAFLOW pipeline
+//-----------------------------------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include "../include/snn_pipeline.h"
+#include "test_utils.h"
+
+using namespace std;
+
+const int TIMESTEPS = 20;
+
+// Diagonal weight of ~120 in every precision: code x (1 << row scale)
+const int DIAG_CODE = (WEIGHT_CODE_MAX > 120) ? 120 : WEIGHT_CODE_MAX;
+const int DIAG_SHIFT = (WEIGHT_CODE_MAX > 120) ? 0 : (WEIGHT_CODE_MAX > 1) ? 4 : 7;
+
+// Frame with a single bright channel
+void make_frame(input_data_t &frame, int bright_channel, int frame_id) {
+    for (int i = 0; i < MAX_INPUT_CHANNELS; i++) {
+        frame.pixels[i] = 0;
+    }
+    frame.pixels[bright_channel] = 255;
+    frame.label = bright_channel;
+    frame.frame_id = frame_id;
+}
+
+int main() {
+    cout << "==============================================\n";
+    cout << "SNN Pipeline Testbench\n";
+    cout << "==============================================\n";
+
+    // Input channel i drives output neuron i for the first 10 channels
+    static weight_code_t weights[MAX_SYNAPSES];
+    static weight_beat_t weight_memory[WEIGHT_BEATS];
+    weight_scale_t row_scale[MAX_NEURONS] = {0};
+    static decay_epoch_t row_epoch[MAX_NEURONS];
+    for (int i = 0; i < MAX_SYNAPSES; i++) {
+        weights[i] = 0;
+    }
+    for (int i = 0; i < MAX_OUTPUT_NEURONS; i++) {
+        weights[i * MAX_NEURONS + i] = DIAG_CODE;
+        row_scale[i] = DIAG_SHIFT;
+    }
+    pack_weights(weights, weight_memory, MAX_SYNAPSES);
+
+    network_config_t config;
+    config.mode = MODE_INFERENCE;
+    config.encoding_type = PHASE_CODING;
+    config.decoding_type = SPIKE_COUNT;
+    config.batch_size = MAX_OUTPUT_NEURONS;
+
+    encoder_config_t enc_config;
+    enc_config.encoding_type = PHASE_CODING;
+    enc_config.num_channels = MAX_NEURONS;
+    enc_config.time_window = TIMESTEPS;
+    enc_config.phase_scale = 16;
+    enc_config.phase_threshold = 256;
+    enc_config.default_weight = 1;
+
+    core_config_t core_config;
+    core_config.threshold = 100;
+    core_config.leak_rate = 10;
+    core_config.refractory_period = 0;
+
+    learning_config_t learn_config;
+    learn_config.a_plus = 0.1;
+    learn_config.a_minus = 0.1;
+    learn_config.tau_plus = 20.0;
+    learn_config.tau_minus = 20.0;
+    learn_config.stdp_window = 10;
+
+    weight_config_t weight_config;
+    weight_config.max_weight = MAX_WEIGHT;
+    weight_config.min_weight = MIN_WEIGHT;
+    weight_config.enable_decay = false;
+    weight_config.decay_rate = 255;
+    weight_config.decay_epoch_shift = 0;
+    weight_config.sparse = false;
+    weight_config.enable_normalization = false;
+    weight_config.norm_target = 0;
+
+    decoder_config_t dec_config;
+    dec_config.decoding_type = SPIKE_COUNT;
+    dec_config.num_outputs = MAX_OUTPUT_NEURONS;
+    dec_config.window_size = TIMESTEPS;
+    dec_config.rate_alpha = 0.5;
+
+    hls::stream<input_data_t> input_data;
+    hls::stream<frame_control_t> frame_ctrl;
+    hls::stream<output_data_t> output_data;
+    hls::stream<weight_update_t> weight_updates;
+    ap_uint<32> frames_done, spikes_encoded, spikes_fired, updates_issued;
+    pipeline_status_t status_block;
+    spike_time_t start_time = 0;    // Global timestep carried across runs
+
+    int total_errors = 0;
+
+    //-------------------------------------------------------------------------
+    // Test 1: Frames Reach the Decoder
+    //-------------------------------------------------------------------------
+    cout << "\nTest 1: Frames Reach the Decoder\n";
+    cout << "----------------------------------------\n";
+
+    for (int f = 0; f < MAX_OUTPUT_NEURONS; f++) {
+        input_data_t frame;
+        make_frame(frame, f, 100 + f);
+        input_data.write(frame);
+    }
+
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, start_time,
+                 input_data, false, frame_ctrl, weight_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+    start_time += config.batch_size * TIMESTEPS;
+
+    int correct = 0;
+    int outputs = 0;
+    while (!output_data.empty()) {
+        output_data_t output = output_data.read();
+        if (output.frame_id == 100 + outputs && output.class_id == outputs) {
+            correct++;
+        }
+        outputs++;
+    }
+
+    cout << "Frames: " << frames_done << ", encoded spikes: " << spikes_encoded
+         << ", fired spikes: " << spikes_fired << "\n";
+
+    if (outputs == MAX_OUTPUT_NEURONS && correct == MAX_OUTPUT_NEURONS &&
+        frames_done == MAX_OUTPUT_NEURONS) {
+        cout << "PASS: Every frame classified by its bright channel, in order\n";
+    } else {
+        cout << "FAIL: " << correct << " of " << outputs << " outputs correct\n";
+        total_errors++;
+    }
+
+    if (weight_updates.empty() && updates_issued == 0) {
+        cout << "PASS: No weight updates in inference mode\n";
+    } else {
+        cout << "FAIL: Inference mode issued " << updates_issued << " updates\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 2: Training Mode Issues STDP Updates
+    //-------------------------------------------------------------------------
+    cout << "\nTest 2: Training Mode Issues STDP Updates\n";
+    cout << "----------------------------------------\n";
+
+    config.mode = MODE_TRAINING;
+    config.batch_size = 1;
+    input_data_t frame;
+    make_frame(frame, 3, 200);
+    input_data.write(frame);
+
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, start_time,
+                 input_data, false, frame_ctrl, weight_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+    start_time += config.batch_size * TIMESTEPS;
+    output_data.read();
+
+    // Channel 3 spikes and drives neuron 3 within the same step: causal, so LTP
+    bool saw_ltp = false;
+    int updates = 0;
+    while (!weight_updates.empty()) {
+        weight_update_t update = weight_updates.read();
+        if (update.pre_id == 3 && update.post_id == 3 && update.delta > 0) {
+            saw_ltp = true;
+        }
+        updates++;
+    }
+
+    if (saw_ltp && updates == updates_issued) {
+        cout << "PASS: " << updates << " updates issued, including LTP on 3 -> 3\n";
+    } else {
+        cout << "FAIL: " << updates << " updates, LTP on 3 -> 3 "
+             << (saw_ltp ? "seen" : "missing") << "\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 3: Throughput
+    //-------------------------------------------------------------------------
+    cout << "\nTest 3: Throughput\n";
+    cout << "----------------------------------------\n";
+
+    const int THROUGHPUT_FRAMES = 64;
+    config.mode = MODE_INFERENCE;
+    config.batch_size = THROUGHPUT_FRAMES;
+    for (int f = 0; f < THROUGHPUT_FRAMES; f++) {
+        make_frame(frame, f % MAX_OUTPUT_NEURONS, f);
+        input_data.write(frame);
+    }
+
+    Timer timer;
+    timer.start();
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, start_time,
+                 input_data, false, frame_ctrl, weight_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+    timer.stop();
+    start_time += config.batch_size * TIMESTEPS;
+
+    double elapsed_us = timer.getTime();
+    int frames_out = 0;
+    while (!output_data.empty()) {
+        output_data.read();
+        frames_out++;
+    }
+
+    cout << "C-sim throughput: " << fixed << setprecision(1)
+         << (elapsed_us > 0 ? THROUGHPUT_FRAMES * 1e6 / elapsed_us : 0.0)
+         << " frames/s (" << THROUGHPUT_FRAMES << " frames, " << TIMESTEPS
+         << " timesteps each)\n";
+
+    if (frames_out == THROUGHPUT_FRAMES && frames_done == THROUGHPUT_FRAMES) {
+        cout << "PASS: All " << frames_out << " frames produced an output\n";
+    } else {
+        cout << "FAIL: " << frames_out << " of " << THROUGHPUT_FRAMES << " frames\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 4: Stage Performance Counters
+    //-------------------------------------------------------------------------
+    cout << "\nTest 4: Stage Performance Counters\n";
+    cout << "----------------------------------------\n";
+
+    const char *stage_names[] = {"dispatch", "encoder", "core", "learning", "decoder"};
+    performance_counter_t *stages[] = {&status_block.dispatch, &status_block.encoder,
+                                       &status_block.core, &status_block.learning,
+                                       &status_block.decoder};
+    bool counters_ok = status_block.dispatch.operations == THROUGHPUT_FRAMES;
+    for (int i = 0; i < 5; i++) {
+        performance_counter_t &perf = *stages[i];
+        cout << setw(10) << stage_names[i] << ": cycles=" << perf.cycles
+             << " ops=" << perf.operations << " empty=" << perf.empty_stalls
+             << " full=" << perf.full_stalls << " eff=" << perf.get_efficiency() << "%\n";
+        counters_ok &= perf.operations > 0 &&
+                       perf.cycles == perf.operations + perf.stalls &&
+                       perf.stalls == perf.empty_stalls + perf.full_stalls;
+    }
+
+    if (counters_ok) {
+        cout << "PASS: Status block holds consistent counters for every stage\n";
+    } else {
+        cout << "FAIL: Inconsistent stage counters\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 5: Owed Decay Applied on Reload
+    //-------------------------------------------------------------------------
+    cout << "\nTest 5: Owed Decay Applied on Reload\n";
+    cout << "----------------------------------------\n";
+
+    // Rows last decayed at epoch 0 owe ~start_time halvings: nothing may fire
+    weight_config.enable_decay = true;
+    weight_config.decay_rate = 127;
+    config.batch_size = 1;
+    make_frame(frame, 3, 300);
+    input_data.write(frame);
+
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, start_time,
+                 input_data, false, frame_ctrl, weight_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+    output_data.read();
+    ap_uint<32> decayed_spikes = spikes_fired;
+
+    // Rows already brought up to date owe nothing and fire as before
+    for (int i = 0; i < MAX_NEURONS; i++) {
+        row_epoch[i] = start_time;
+    }
+    input_data.write(frame);
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, start_time,
+                 input_data, false, frame_ctrl, weight_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+    output_data_t fresh = output_data.read();
+    start_time += config.batch_size * TIMESTEPS;
+
+    bool memory_kept = weight_lane_get(weight_memory[(3 * MAX_NEURONS + 3) / WEIGHTS_PER_BEAT],
+                                       (3 * MAX_NEURONS + 3) % WEIGHTS_PER_BEAT) == DIAG_CODE;
+    if (decayed_spikes == 0 && spikes_fired > 0 && fresh.class_id == 3 && memory_kept) {
+        cout << "PASS: Owed decay silenced stale rows, current rows fired "
+             << spikes_fired << " spikes, memory untouched\n";
+    } else {
+        cout << "FAIL: Stale rows fired " << decayed_spikes << ", current rows "
+             << spikes_fired << ", memory " << (memory_kept ? "kept" : "changed") << "\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 6: Per-Frame Control from the Job Ring
+    //-------------------------------------------------------------------------
+    cout << "\nTest 6: Per-Frame Control from the Job Ring\n";
+    cout << "----------------------------------------\n";
+
+    // One batch mixing jobs of different lengths and modes, as the ring issues
+    weight_config.enable_decay = false;
+    config.mode = MODE_INFERENCE;
+    config.batch_size = 3;
+    const int job_steps[3] = {20, 5, 10};
+    const int job_modes[3] = {MODE_INFERENCE, MODE_TRAINING, MODE_INFERENCE};
+    spike_time_t job_start[3];
+    for (int j = 0; j < 3; j++) {
+        frame_control_t ctrl;
+        ctrl.start_time = start_time;
+        ctrl.timesteps = job_steps[j];
+        ctrl.mode = job_modes[j];
+        ctrl.context_id = 0;
+        ctrl.weight_base = 0;
+        ctrl.encoder = enc_config;
+        ctrl.decoder = dec_config;
+        job_start[j] = start_time;
+        start_time += job_steps[j];
+        frame_ctrl.write(ctrl);
+        make_frame(frame, 2 + j, 400 + j);
+        input_data.write(frame);
+    }
+
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, 0,
+                 input_data, true, frame_ctrl, weight_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+
+    output_data_t job_out[3];
+    for (int j = 0; j < 3; j++) {
+        job_out[j] = output_data.read();
+    }
+
+    // Only the training job learns, and only inside its own timesteps
+    int ring_updates = 0;
+    bool updates_in_job = true;
+    while (!weight_updates.empty()) {
+        weight_update_t update = weight_updates.read();
+        updates_in_job &= update.timestamp >= job_start[1] &&
+                          update.timestamp < job_start[1] + job_steps[1];
+        ring_updates++;
+    }
+
+    int long_count = job_out[0].values[2];
+    int short_count = job_out[1].values[3];
+    cout << "Spike counts: " << long_count << " over " << job_steps[0] << " steps, "
+         << short_count << " over " << job_steps[1] << " steps; "
+         << ring_updates << " updates\n";
+
+    if (frames_done == 3 && job_out[0].class_id == 2 && job_out[2].class_id == 4 &&
+        short_count <= job_steps[1] && long_count > short_count &&
+        ring_updates > 0 && updates_in_job && frame_ctrl.empty()) {
+        cout << "PASS: Each job ran for its own timesteps and mode\n";
+    } else {
+        cout << "FAIL: Per-frame control not applied\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test 7: Per-Frame Contexts
+    //-------------------------------------------------------------------------
+    cout << "\nTest 7: Per-Frame Contexts\n";
+    cout << "----------------------------------------\n";
+
+    // Two models back to back in weight memory: the diagonal one, and one
+    // that routes channel i to neuron i + 1
+    static weight_beat_t model_memory[2 * WEIGHT_BEATS];
+    for (int i = 0; i < MAX_SYNAPSES; i++) {
+        weights[i] = 0;
+    }
+    for (int i = 0; i < MAX_OUTPUT_NEURONS; i++) {
+        weights[i * MAX_NEURONS + (i + 1) % MAX_OUTPUT_NEURONS] = DIAG_CODE;
+    }
+    pack_weights(weights, model_memory + WEIGHT_BEATS, MAX_SYNAPSES);
+    for (int b = 0; b < WEIGHT_BEATS; b++) {
+        model_memory[b] = weight_memory[b];
+    }
+
+    // Contexts: diagonal, shifted, decoder limited to 5 outputs, encoder
+    // with no channels
+    const int ctx_base[4] = {0, WEIGHT_BEATS, 0, 0};
+    const int ctx_outputs[4] = {MAX_OUTPUT_NEURONS, MAX_OUTPUT_NEURONS, 5, MAX_OUTPUT_NEURONS};
+    const int ctx_channels[4] = {MAX_NEURONS, MAX_NEURONS, MAX_NEURONS, 0};
+    const int ctx_bright[4] = {2, 2, 7, 4};
+    config.batch_size = 4;
+    for (int j = 0; j < 4; j++) {
+        frame_control_t ctrl;
+        ctrl.start_time = start_time;
+        ctrl.timesteps = TIMESTEPS;
+        ctrl.mode = MODE_INFERENCE;
+        ctrl.context_id = j;
+        ctrl.weight_base = ctx_base[j];
+        ctrl.encoder = enc_config;
+        ctrl.encoder.num_channels = ctx_channels[j];
+        ctrl.decoder = dec_config;
+        ctrl.decoder.num_outputs = ctx_outputs[j];
+        start_time += TIMESTEPS;
+        frame_ctrl.write(ctrl);
+        make_frame(frame, ctx_bright[j], 500 + j);
+        input_data.write(frame);
+    }
+
+    snn_pipeline(config, enc_config, core_config, learn_config, dec_config, 0,
+                 input_data, true, frame_ctrl, model_memory, 0, row_scale, row_epoch,
+                 weight_config, output_data, weight_updates,
+                 frames_done, spikes_encoded, spikes_fired, updates_issued, &status_block);
+
+    output_data_t ctx_out[4];
+    for (int j = 0; j < 4; j++) {
+        ctx_out[j] = output_data.read();
+    }
+    int silent_total = 0;
+    for (int i = 0; i < MAX_OUTPUT_NEURONS; i++) {
+        silent_total += ctx_out[3].values[i];
+    }
+
+    cout << "Classes: " << ctx_out[0].class_id << ", " << ctx_out[1].class_id << ", "
+         << ctx_out[2].class_id << "; silent frame total " << silent_total << "\n";
+
+    if (ctx_out[0].class_id == 2 && ctx_out[1].class_id == 3 &&
+        ctx_out[2].class_id < 5 && ctx_out[2].values[7] > 0 && silent_total == 0) {
+        cout << "PASS: Each frame used its own context's weights, encoder and decoder\n";
+    } else {
+        cout << "FAIL: Frame contexts not applied\n";
+        total_errors++;
+    }
+
+    //-------------------------------------------------------------------------
+    // Test Summary
+    //-------------------------------------------------------------------------
+    cout << "\n==============================================\n";
+    cout << "Test Summary\n";
+    cout << "==============================================\n";
+    cout << "Total Tests: 7\n";
+    cout << "Errors: " << total_errors << "\n";
+
+    if (total_errors == 0) {
+        cout << "\nALL TESTS PASSED!\n";
+        return 0;
+    } else {
+        cout << "\nTEST FAILED with " << total_errors << " errors\n";
+        return 1;
+    }
+}
@@ -51,6 +51,10 @@ int main() {
     // Control
     bool enable = true;
     ap_uint<32> status;
+    int timestep = 0;              // Global timestep, one tick per call
+    int config_seq = 0;            // Bumped whenever the test changes config
+    ap_uint<8> active_seq;
+    performance_counter_t perf;
     
     int total_errors = 0;
     
@@ -69,7 +73,8 @@ int main() {
     
     // Process for one window
     for (int t = 0; t < config.window_size; t++) {
-        spike_decoder(enable, config, spikes_in, data_out, status);
+        spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                      active_seq, perf);
     }
     
     // Check output
@@ -103,6 +108,7 @@ int main() {
     cout << "----------------------------------------\n";
     
     config.decoding_type = SPIKE_RATE;
+    config_seq++;
     
     // Clear previous data
     while (!data_out.empty()) data_out.read();
@@ -120,7 +126,8 @@ int main() {
         
         // Process window
         for (int t = 0; t < config.window_size; t++) {
-            spike_decoder(enable, config, spikes_in, data_out, status);
+            spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                          active_seq, perf);
         }
     }
     
@@ -145,7 +152,8 @@ int main() {
     
     // Process window with no spikes
     for (int t = 0; t < config.window_size; t++) {
-        spike_decoder(enable, config, spikes_in, data_out, status);
+        spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                      active_seq, perf);
     }
     
     if (!data_out.empty()) {
@@ -178,13 +186,15 @@ int main() {
     for (int w = 0; w < 3; w++) {
         config.window_size = window_sizes[w];
         config.decoding_type = SPIKE_COUNT;
+        config_seq++;
         
         // Generate consistent spike pattern
         generate_spike_pattern(spikes_in, 3, 10, 0, 5);
         
         // Process
         for (int t = 0; t < config.window_size; t++) {
-            spike_decoder(enable, config, spikes_in, data_out, status);
+            spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                          active_seq, perf);
         }
         
         cout << "Window size " << window_sizes[w] << ": ";
@@ -195,6 +205,7 @@ int main() {
     }
     
     config.window_size = 100; // Reset to default
+    config_seq++;
     
     //-------------------------------------------------------------------------
     // Test 5: Disable Functionality
@@ -206,7 +217,8 @@ int main() {
     
     // Try to process when disabled
     generate_spike_pattern(spikes_in, 0, 10, 0, 1);
-    spike_decoder(enable, config, spikes_in, data_out, status);
+    spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status, active_seq,
+                  perf);
     
     if ((status & 0x80000000) != 0) {
         cout << "PASS: Disabled flag set\n";
@@ -224,6 +236,7 @@ int main() {
     cout << "----------------------------------------\n";
     
     config.decoding_type = SPIKE_COUNT;
+    config_seq++;
     
     // Simulate continuous inference
     int correct_classifications = 0;
@@ -240,7 +253,8 @@ int main() {
         
         // Process window
         for (int t = 0; t < config.window_size; t++) {
-            spike_decoder(enable, config, spikes_in, data_out, status);
+            spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                          active_seq, perf);
         }
         
         // Check classification
@@ -260,13 +274,63 @@ int main() {
         total_errors++;
     }
     
+    //-------------------------------------------------------------------------
+    // Test 7: Shadow Config Commit at Window Boundary
+    //-------------------------------------------------------------------------
+    cout << "\nTest 7: Shadow Config Commit at Window Boundary\n";
+    cout << "----------------------------------------\n";
+    
+    // Run until a window closes so the next call opens a fresh one
+    while (!data_out.empty()) data_out.read();
+    for (int t = 0; t < config.window_size && data_out.empty(); t++) {
+        spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                      active_seq, perf);
+    }
+    while (!data_out.empty()) data_out.read();
+    
+    // Open a window, then rewrite the shadow config mid-window
+    spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                  active_seq, perf);
+    config.window_size = 50;
+    config_seq++;
+    
+    int calls = 1;
+    while (data_out.empty() && calls < 200) {
+        spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                      active_seq, perf);
+        calls++;
+    }
+    data_out.read();
+    int open_window = calls;
+    
+    // The new window size applies from the next window on
+    calls = 0;
+    while (data_out.empty() && calls < 200) {
+        spike_decoder(enable, ++timestep, config, config_seq, spikes_in, data_out, status,
+                      active_seq, perf);
+        calls++;
+    }
+    data_out.read();
+    
+    cout << "Window open at commit: " << open_window << " steps, next window: "
+         << calls << " steps\n";
+    if (open_window == 100 && calls == 50 && active_seq == config_seq) {
+        cout << "PASS: Shadow config committed at the window boundary\n";
+    } else {
+        cout << "FAIL: Shadow config applied mid-window or not at all\n";
+        total_errors++;
+    }
+    
+    config.window_size = 100;
+    config_seq++;
+    
     //-------------------------------------------------------------------------
     // Test Summary
     //-------------------------------------------------------------------------
     cout << "\n==============================================\n";
     cout << "Test Summary\n";
     cout << "==============================================\n";
-    cout << "Total Tests: 6\n";
+    cout << "Total Tests: 7\n";
     cout << "Errors: " << total_errors << "\n";
     
     if (total_errors == 0) {
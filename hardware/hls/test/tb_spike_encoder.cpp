@@ -94,6 +94,10 @@ int main() {
     // Control
     bool enable = true;
     ap_uint<32> spike_count;
+    int timestep = 0;              // Global timestep, one tick per call
+    int config_seq = 0;            // Bumped whenever the test changes config
+    ap_uint<8> active_seq;
+    performance_counter_t perf;
     
     int total_errors = 0;
     
@@ -113,7 +117,8 @@ int main() {
     // Run encoder for multiple time steps
     int spike_counts[MAX_INPUT_CHANNELS];
     for (int t = 0; t < 1000; t++) {
-        spike_encoder(enable, config, data_in, spikes_out, spike_count);
+        spike_encoder(enable, ++timestep, config, config_seq, data_in, spikes_out, spike_count,
+                      active_seq, perf);
     }
     
     count_spikes_per_channel(spikes_out, spike_counts, 1000);
@@ -144,6 +149,7 @@ int main() {
     cout << "----------------------------------------\n";
     
     config.encoding_type = TEMPORAL_CODING;
+    config_seq++;
     
     // Clear streams
     while (!spikes_out.empty()) spikes_out.read();
@@ -158,7 +164,8 @@ int main() {
     bool spike_seen[MAX_INPUT_CHANNELS] = {false};
     
     for (int t = 0; t < config.time_window; t++) {
-        spike_encoder(enable, config, data_in, spikes_out, spike_count);
+        spike_encoder(enable, ++timestep, config, config_seq, data_in, spikes_out, spike_count,
+                      active_seq, perf);
         
         // Record first spike times
         while (!spikes_out.empty()) {
@@ -193,6 +200,7 @@ int main() {
     cout << "----------------------------------------\n";
     
     config.encoding_type = PHASE_CODING;
+    config_seq++;
     
     // Test with constant input
     for (int i = 0; i < MAX_INPUT_CHANNELS; i++) {
@@ -203,7 +211,8 @@ int main() {
     // Run for extended period
     int phase_spike_count = 0;
     for (int t = 0; t < 2000; t++) {
-        spike_encoder(enable, config, data_in, spikes_out, spike_count);
+        spike_encoder(enable, ++timestep, config, config_seq, data_in, spikes_out, spike_count,
+                      active_seq, perf);
         
         while (!spikes_out.empty()) {
             spikes_out.read();
@@ -233,11 +242,13 @@ int main() {
     
     for (int enc_type = 0; enc_type < 3; enc_type++) {
         config.encoding_type = (encoding_type_t)enc_type;
+        config_seq++;
         data_in.write(test_data);
         
         int zero_spikes = 0;
         for (int t = 0; t < 100; t++) {
-            spike_encoder(enable, config, data_in, spikes_out, spike_count);
+            spike_encoder(enable, ++timestep, config, config_seq, data_in, spikes_out, spike_count,
+                          active_seq, perf);
             while (!spikes_out.empty()) {
                 spikes_out.read();
                 zero_spikes++;
@@ -257,12 +268,14 @@ int main() {
     
     enable = false;
     config.encoding_type = RATE_CODING;
+    config_seq++;
     
     generate_test_image(test_data, 1); // All max
     data_in.write(test_data);
     
     ap_uint<32> prev_count = spike_count;
-    spike_encoder(enable, config, data_in, spikes_out, spike_count);
+    spike_encoder(enable, ++timestep, config, config_seq, data_in, spikes_out, spike_count,
+                  active_seq, perf);
     
     if (spike_count == prev_count) {
         cout << "PASS: No spikes generated when disabled\n";
@@ -279,6 +292,7 @@ int main() {
     
     enable = true;
     config.encoding_type = RATE_CODING;
+    config_seq++;
     
     // Create simple digit-like pattern (vertical line)
     for (int i = 0; i < 784; i++) {
@@ -295,7 +309,8 @@ int main() {
     // Encode for 500 time steps
     int pattern_spikes = 0;
     for (int t = 0; t < 500; t++) {
-        spike_encoder(enable, config, data_in, spikes_out, spike_count);
+        spike_encoder(enable, ++timestep, config, config_seq, data_in, spikes_out, spike_count,
+                      active_seq, perf);
         while (!spikes_out.empty()) {
             spike_event_t spike = spikes_out.read();
             pattern_spikes++;
@@ -15,14 +15,14 @@
 using namespace std;
 
 // Initialize weight memory
-void init_weights(weight_t *weights, int size, weight_t value) {
+void init_weights(weight_code_t *weights, int size, weight_code_t value) {
     for (int i = 0; i < size; i++) {
         weights[i] = value;
     }
 }
 
 // Check weight bounds
-bool check_weight_bounds(weight_t *weights, int size, weight_t min, weight_t max) {
+bool check_weight_bounds(weight_code_t *weights, int size, weight_t min, weight_t max) {
     for (int i = 0; i < size; i++) {
         if (weights[i] < min || weights[i] > max) {
             return false;
@@ -31,13 +31,56 @@ bool check_weight_bounds(weight_t *weights, int size, weight_t min, weight_t max
     return true;
 }
 
+// Row decay epochs and scales, shared by every updater call like the DDR tables
+static decay_epoch_t row_epoch[MAX_NEURONS];
+static weight_scale_t row_scale[MAX_NEURONS];
+static performance_counter_t updater_perf;      // Counters after the last call
+
+// Code-unit test values that fit every weight precision
+const int CSR_CODE = (WEIGHT_CODE_MAX > 40) ? 40 : WEIGHT_CODE_MAX / 2 + 1;
+const int DIRTY_CODE = (WEIGHT_CODE_MAX > 20) ? 20 : 0;
+
+// Saturating code addition, as the updater's bounds check does with a zero row scale
+int clamp_code(int code) {
+    if (code > WEIGHT_CODE_MAX) return WEIGHT_CODE_MAX;
+    if (code < WEIGHT_CODE_MIN) return WEIGHT_CODE_MIN;
+    return code;
+}
+
+// Run the updater on a packed copy of the host-side weight matrix
+void run_updater(
+    bool enable,
+    bool reset,
+    hls::stream<weight_update_t> &updates_in,
+    weight_code_t *weights,
+    weight_config_t config,
+    ap_uint<32> &updates_applied
+) {
+    static weight_beat_t packed[WEIGHT_BEATS];
+    static csr_ptr_t row_ptr[MAX_NEURONS + 1] = {0};
+    static neuron_id_t col_idx[MAX_SYNAPSES];
+    static hls::stream<weight_row_beat_t> dirty_out;
+    dirty_bitmap_t dirty_bitmap;
+    ap_uint<8> active_seq;
+    
+    // Commit the caller's config with every batch
+    static int config_seq = 0;
+    config_seq++;
+    
+    pack_weights(weights, packed, MAX_SYNAPSES);
+    weight_updater(enable, reset, false, false, 0, updates_in, packed, row_epoch, row_ptr, col_idx,
+                   row_scale, config, config_seq, dirty_out, updates_applied, dirty_bitmap,
+                   active_seq, updater_perf);
+    unpack_weights(packed, weights, MAX_SYNAPSES);
+}
+
 int main() {
     cout << "==============================================\n";
     cout << "Weight Updater Testbench\n";
     cout << "==============================================\n";
     
-    // Allocate weight memory
-    weight_t weight_memory[MAX_SYNAPSES];
+    // Allocate weight memory (host copy in code units)
+    static weight_code_t weight_memory[MAX_SYNAPSES];
     
     // Test streams
     hls::stream<weight_update_t> updates_in("updates_in");
@@ -48,6 +91,8 @@ int main() {
     config.min_weight = -100;
     config.enable_decay = false;
     config.decay_rate = 250; // Minimal decay
+    config.decay_epoch_shift = 0; // One epoch per timestamp
+    config.sparse = false;
     config.enable_normalization = false;
     config.norm_target = 1000;
     
@@ -57,7 +102,9 @@ int main() {
     ap_uint<32> updates_applied;
     
     int total_errors = 0;
+    weight_update_t update;
     
+#if WEIGHT_PRECISION == WEIGHT_PRECISION_INT8
     //-------------------------------------------------------------------------
     // Test 1: Basic Weight Update
     //-------------------------------------------------------------------------
@@ -68,7 +115,6 @@ int main() {
     init_weights(weight_memory, MAX_SYNAPSES, 50);
     
     // Create weight update
-    weight_update_t update;
     update.pre_id = 0;
     update.post_id = 1;
     update.delta = 20;
@@ -76,7 +122,7 @@ int main() {
     updates_in.write(update);
     
     // Apply update
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
     // Check result
     int addr = update.pre_id * MAX_NEURONS + update.post_id;
@@ -87,6 +133,15 @@ int main() {
         total_errors++;
     }
     
+    // Neighbouring lanes of the same beat must be preserved
+    if (weight_memory[addr - 1] == 50 && weight_memory[addr + 1] == 50) {
+        cout << "PASS: Neighbouring weights in the beat untouched\n";
+    } else {
+        cout << "FAIL: Lane merge corrupted neighbours (" << weight_memory[addr - 1]
+             << ", " << weight_memory[addr + 1] << ")\n";
+        total_errors++;
+    }
+    
     //-------------------------------------------------------------------------
     // Test 2: Weight Bounds Checking
     //-------------------------------------------------------------------------
@@ -100,7 +155,7 @@ int main() {
     update.delta = 20; // Would exceed max
     updates_in.write(update);
     
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
     if (weight_memory[10] == config.max_weight) {
         cout << "PASS: Upper bound enforced (" << weight_memory[10] << ")\n";
@@ -116,7 +171,7 @@ int main() {
     update.delta = -20; // Would exceed min
     updates_in.write(update);
     
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
     if (weight_memory[20] == config.min_weight) {
         cout << "PASS: Lower bound enforced (" << weight_memory[20] << ")\n";
@@ -132,22 +187,31 @@ int main() {
     cout << "----------------------------------------\n";
     
     config.enable_decay = true;
-    config.decay_rate = 128; // 50% decay (128/256)
+    config.decay_rate = 128; // ~50% retention per epoch (129/256)
     
-    // Positive weight decay
+    // Positive weight decay: row 0 was last touched at epoch 100
     weight_memory[30] = 80;
     update.pre_id = 0;
     update.post_id = 30;
     update.delta = 0; // No change, just decay
+    update.timestamp = 101;
     updates_in.write(update);
     
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
-    // Should decay by ~50%
-    if (weight_memory[30] < 80 && weight_memory[30] > 30) {
+    // One elapsed epoch should halve the weight
+    if (weight_memory[30] == 40) {
         cout << "PASS: Positive weight decayed to " << weight_memory[30] << "\n";
     } else {
-        cout << "FAIL: Incorrect decay\n";
+        cout << "FAIL: Incorrect decay (" << weight_memory[30] << ", expected 40)\n";
+        total_errors++;
+    }
+    
+    // Untouched synapses in the same row decay lazily with it
+    if (weight_memory[1] == 35) {
+        cout << "PASS: Untouched synapse in row decayed to " << weight_memory[1] << "\n";
+    } else {
+        cout << "FAIL: Untouched synapse not decayed (" << weight_memory[1] << ", expected 35)\n";
         total_errors++;
     }
     
@@ -156,18 +220,103 @@ int main() {
     update.pre_id = 0;
     update.post_id = 31;
     update.delta = 0;
+    update.timestamp = 102;
     updates_in.write(update);
     
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
-    if (weight_memory[31] > -60 && weight_memory[31] < 0) {
+    if (weight_memory[31] == -30) {
         cout << "PASS: Negative weight decayed to " << weight_memory[31] << "\n";
     } else {
-        cout << "FAIL: Incorrect negative decay\n";
+        cout << "FAIL: Incorrect negative decay (" << weight_memory[31] << ", expected -30)\n";
+        total_errors++;
+    }
+    
+    // Several idle epochs are applied in one step on the next touch
+    weight_memory[32] = 96;
+    update.pre_id = 0;
+    update.post_id = 32;
+    update.delta = 0;
+    update.timestamp = 105;
+    updates_in.write(update);
+    
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    
+    if (weight_memory[32] == 12) { // 96 * 0.5^3
+        cout << "PASS: Three idle epochs decayed weight to " << weight_memory[32] << "\n";
+    } else {
+        cout << "FAIL: Incorrect multi-epoch decay (" << weight_memory[32] << ", expected 12)\n";
+        total_errors++;
+    }
+    
+    // Rate 255 is the no-decay setting
+    config.decay_rate = 255;
+    weight_code_t settled = weight_memory[30];
+    weight_memory[33] = 77;
+    update.post_id = 33;
+    update.timestamp = 200;
+    updates_in.write(update);
+    
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    
+    if (weight_memory[33] == 77 && weight_memory[30] == settled) {
+        cout << "PASS: Rate 255 leaves weights unchanged\n";
+    } else {
+        cout << "FAIL: Rate 255 decayed weights (" << weight_memory[33] << ", "
+             << weight_memory[30] << ")\n";
+        total_errors++;
+    }
+    
+    // An idle gap longer than the power table saturates instead of wrapping
+    config.decay_rate = 250;
+    update.timestamp = 200 + 65536;
+    updates_in.write(update);
+    
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    
+    if (weight_memory[33] == 0) {
+        cout << "PASS: 65536 idle epochs decayed weight to 0\n";
+    } else {
+        cout << "FAIL: Long idle gap wrapped (" << weight_memory[33] << ", expected 0)\n";
+        total_errors++;
+    }
+    
+    // Reset seeds every row with the current epoch, so nothing is owed for
+    // the time before it
+    static weight_beat_t seed_memory[WEIGHT_BEATS];
+    weight_scale_t seed_scale[MAX_NEURONS] = {0};
+    hls::stream<weight_row_beat_t> seed_dirty;
+    dirty_bitmap_t seed_bitmap;
+    ap_uint<8> seed_seq;
+    performance_counter_t seed_perf;
+    init_weights(weight_memory, MAX_SYNAPSES, 80);
+    pack_weights(weight_memory, seed_memory, MAX_SYNAPSES);
+    config.decay_rate = 127;    // 50% retention per epoch
+    weight_updater(enable, true, false, false, 5000, updates_in, seed_memory, row_epoch,
+                   NULL, NULL, seed_scale, config, 1, seed_dirty, updates_applied,
+                   seed_bitmap, seed_seq, seed_perf);
+    update.pre_id = 1;
+    update.post_id = 2;
+    update.timestamp = 5001;
+    updates_in.write(update);
+    weight_updater(enable, false, false, false, 5001, updates_in, seed_memory, row_epoch,
+                   NULL, NULL, seed_scale, config, 1, seed_dirty, updates_applied,
+                   seed_bitmap, seed_seq, seed_perf);
+    
+    if (row_epoch[0] == 5000 && weight_lane_get(seed_memory[(MAX_NEURONS + 2) / WEIGHTS_PER_BEAT],
+                                                (MAX_NEURONS + 2) % WEIGHTS_PER_BEAT) == 40) {
+        cout << "PASS: Row epochs seeded at reset, one epoch owed after it\n";
+    } else {
+        cout << "FAIL: Row epoch " << row_epoch[0] << " after reset at 5000\n";
         total_errors++;
     }
     
     config.enable_decay = false; // Disable for next tests
+#else
+    // Tests 1-3 use 8-bit code values; Test 11 covers these paths here
+    cout << "\nTests 1-3: skipped at " << WEIGHT_CODE_BITS << "-bit weight codes\n";
+    update.timestamp = 100;
+#endif
     
     //-------------------------------------------------------------------------
     // Test 4: Multiple Updates
@@ -177,7 +326,7 @@ int main() {
     
     // Reset counter
     reset = true;
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     reset = false;
     
     // Send multiple updates
@@ -190,7 +339,7 @@ int main() {
     
     // Apply all updates
     for (int i = 0; i < 10; i++) {
-        weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+        run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     }
     
     if (updates_applied == 10) {
@@ -214,7 +363,7 @@ int main() {
     update.delta = 50;
     updates_in.write(update);
     
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
     if (updates_applied == prev_count) {
         cout << "PASS: Invalid address ignored\n";
@@ -237,7 +386,7 @@ int main() {
     update.delta = 25;
     updates_in.write(update);
     
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     
     if (updates_applied == prev_count) {
         cout << "PASS: No updates when disabled\n";
@@ -254,7 +403,7 @@ int main() {
     
     enable = true;
     reset = true;
-    weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     reset = false;
     
     // Generate burst of updates
@@ -262,15 +411,15 @@ int main() {
     timer.start();
     
     for (int i = 0; i < 1000; i++) {
-        update.pre_id = rand() % NUM_NEURONS;
-        update.post_id = rand() % NUM_NEURONS;
+        update.pre_id = rand() % MAX_NEURONS;
+        update.post_id = rand() % MAX_NEURONS;
         update.delta = (rand() % 20) - 10;
         updates_in.write(update);
     }
     
     // Apply all updates
     for (int i = 0; i < 1000; i++) {
-        weight_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+        run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
     }
     
     timer.stop();
@@ -286,13 +435,287 @@ int main() {
         total_errors++;
     }
     
+    // Counters follow the stream accesses: one operation per update read,
+    // one empty stall for a call that finds nothing queued
+    int leftover = 0;
+    while (!updates_in.empty()) {
+        run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+        leftover++;
+    }
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    if (updater_perf.operations == 1000 + leftover && updater_perf.empty_stalls == 1 &&
+        updater_perf.cycles == updater_perf.operations + updater_perf.stalls) {
+        cout << "PASS: Counters match the update stream accesses\n";
+    } else {
+        cout << "FAIL: Counters show " << updater_perf.operations << " reads, "
+             << updater_perf.empty_stalls << " empty polls\n";
+        total_errors++;
+    }
+    
+    //-------------------------------------------------------------------------
+    // Test 8: Stochastic Delta Rounding
+    //-------------------------------------------------------------------------
+    cout << "\nTest 8: Stochastic Delta Rounding\n";
+    cout << "----------------------------------------\n";
+    
+    // A delta of 5 at scale 1 << 2 is 1.25 code steps on average
+    ap_uint<16> lfsr = 0xACE1;
+    int step_sum = 0;
+    for (int i = 0; i < 4096; i++) {
+        step_sum += quantize_delta(5, 2, lfsr);
+    }
+    float mean_steps = (float)step_sum / 4096;
+    
+    if (float_equal(mean_steps, 1.25, 0.05)) {
+        cout << "PASS: Mean rounded delta " << mean_steps << " (expected 1.25)\n";
+    } else {
+        cout << "FAIL: Rounding biased, mean " << mean_steps << " (expected 1.25)\n";
+        total_errors++;
+    }
+    
+    if (quantize_delta(-12, 2, lfsr) == -3) {
+        cout << "PASS: Exact multiples round deterministically\n";
+    } else {
+        cout << "FAIL: Exact multiple  rounded to " << quantize_delta(-12, 2, lfsr) << "\n";
+        total_errors++;
+    }
+    
+    //-------------------------------------------------------------------------
+    // Test 9: Sparse CSR Weight Store
+    //-------------------------------------------------------------------------
+    cout << "\nTest 9: Sparse CSR Weight Store\n";
+    cout << "----------------------------------------\n";
+    
+    // ~5% connectivity: each row connects to every 20th neuron
+    static weight_code_t dense[MAX_SYNAPSES];
+    init_weights(dense, MAX_SYNAPSES, 0);
+    for (int pre = 0; pre < MAX_NEURONS; pre++) {
+        for (int post = pre % 20; post < MAX_NEURONS; post += 20) {
+            dense[pre * MAX_NEURONS + post] = CSR_CODE;
+        }
+    }
+    
+    static csr_ptr_t csr_row_ptr[MAX_NEURONS + 1];
+    static neuron_id_t csr_col_idx[MAX_SYNAPSES];
+    static weight_code_t csr_values[MAX_SYNAPSES];
+    static weight_beat_t csr_memory[WEIGHT_BEATS];
+    weight_scale_t csr_scale[MAX_NEURONS] = {0};
+    hls::stream<weight_row_beat_t> dirty_out;
+    dirty_bitmap_t dirty_bitmap;
+    ap_uint<8> active_seq;
+    int config_seq = 0;
+    performance_counter_t perf;
+    
+    int nnz = dense_to_csr(dense, csr_row_ptr, csr_col_idx, csr_values);
+    pack_weights(csr_values, csr_memory, nnz);
+    cout << "CSR store holds " << nnz << " of " << MAX_SYNAPSES << " synapses\n";
+    
+    // Drop anything left over from the disabled-update test
+    while (!updates_in.empty()) {
+        updates_in.read();
+    }
+    
+    config.sparse = true;
+    config_seq++;
+    reset = true;
+    weight_updater(enable, reset, false, false, 0, updates_in, csr_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    reset = false;
+    
+    // Existing synapse 3 -> 43 is the third entry of row 3
+    update.pre_id = 3;
+    update.post_id = 43;
+    update.delta = 15;
+    updates_in.write(update);
+    weight_updater(enable, reset, false, false, 0, updates_in, csr_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    
+    int slot = csr_row_ptr[3] + 2;
+    weight_code_t sparse_weight = weight_lane_get(csr_memory[slot / WEIGHTS_PER_BEAT],
+                                             slot % WEIGHTS_PER_BEAT);
+    if (csr_col_idx[slot] == 43 && sparse_weight == clamp_code(CSR_CODE + 15)) {
+        cout << "PASS: CSR synapse updated (" << CSR_CODE << " + 15 = " << sparse_weight << ")\n";
+    } else {
+        cout << "FAIL: CSR synapse = " << sparse_weight << ", expected "
+             << clamp_code(CSR_CODE + 15) << "\n";
+        total_errors++;
+    }
+    
+    // Unconnected pairs have no slot and must be ignored
+    prev_count = updates_applied;
+    update.pre_id = 3;
+    update.post_id = 44;
+    updates_in.write(update);
+    weight_updater(enable, reset, false, false, 0, updates_in, csr_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    
+    if (updates_applied == prev_count) {
+        cout << "PASS: Update to unconnected pair ignored\n";
+    } else {
+        cout << "FAIL: Update to unconnected pair applied\n";
+        total_errors++;
+    }
+    
+    config.sparse = false;
+    config_seq++;
+    
+    //-------------------------------------------------------------------------
+    // Test 10: Dirty-Row Readback
+    //-------------------------------------------------------------------------
+    cout << "\nTest 10: Dirty-Row Readback\n";
+    cout << "----------------------------------------\n";
+    
+    static weight_beat_t dense_memory[WEIGHT_BEATS];
+    init_weights(weight_memory, MAX_SYNAPSES, DIRTY_CODE);
+    pack_weights(weight_memory, dense_memory, MAX_SYNAPSES);
+    
+    reset = true;
+    weight_updater(enable, reset, false, false, 0, updates_in, dense_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    reset = false;
+    
+    update.delta = 5;
+    update.pre_id = 2;
+    update.post_id = 9;
+    updates_in.write(update);
+    update.pre_id = 5;
+    update.post_id = 1;
+    updates_in.write(update);
+    for (int i = 0; i < 2; i++) {
+        weight_updater(enable, reset, false, false, 0, updates_in, dense_memory, row_epoch,
+                       csr_row_ptr, csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                       dirty_bitmap, active_seq, perf);
+    }
+    
+    // Fetch-and-clear reports rows 2 and 5, then nothing
+    weight_updater(false, reset, true, false, 0, updates_in, dense_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    dirty_bitmap_t fetched = dirty_bitmap;
+    weight_updater(false, reset, false, false, 0, updates_in, dense_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    
+    dirty_bitmap_t expected_rows = 0;
+    expected_rows[2] = 1;
+    expected_rows[5] = 1;
+    if (fetched == expected_rows && dirty_bitmap == 0) {
+        cout << "PASS: Dirty bitmap fetched and cleared\n";
+    } else {
+        cout << "FAIL: Dirty bitmap 0x" << hex << fetched.to_uint64() << dec
+             << ", after clear " << dirty_bitmap.to_uint64() << "\n";
+        total_errors++;
+    }
+    
+    // Streamed readback returns only the touched row
+    update.pre_id = 7;
+    update.post_id = 12;
+    updates_in.write(update);
+    weight_updater(enable, reset, false, false, 0, updates_in, dense_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    weight_updater(false, reset, false, true, 0, updates_in, dense_memory, row_epoch, csr_row_ptr,
+                   csr_col_idx, csr_scale, config, config_seq, dirty_out, updates_applied,
+                   dirty_bitmap, active_seq, perf);
+    
+    int beats = 0;
+    bool records_ok = true;
+    bool saw_update = false;
+    while (!dirty_out.empty()) {
+        weight_row_beat_t record = dirty_out.read();
+        records_ok &= (record.row == 7) && (record.beat == 7 * BEATS_PER_ROW + beats) &&
+                      (record.last == (beats == BEATS_PER_ROW - 1)) &&
+                      (record.data == dense_memory[record.beat]);
+        for (int lane = 0; lane < WEIGHTS_PER_BEAT; lane++) {
+            saw_update |= (weight_lane_get(record.data, lane) == clamp_code(DIRTY_CODE + 5));
+        }
+        beats++;
+    }
+    
+    if (records_ok && saw_update && beats == BEATS_PER_ROW) {
+        cout << "PASS: Streamed " << beats << " beats of dirty row 7\n";
+    } else {
+        cout << "FAIL: Dirty-row stream (" << beats << " beats)\n";
+        total_errors++;
+    }
+    
+    //-------------------------------------------------------------------------
+    // Test 11: Scaled Code Update and Decay
+    //-------------------------------------------------------------------------
+    cout << "\nTest 11: Scaled Code Update and Decay\n";
+    cout << "----------------------------------------\n";
+    
+    // Row 4 stores codes at 1 << shift weight units (no scaling at 8 bits)
+    const int shift = 8 - WEIGHT_CODE_BITS;
+    const int max_code = (config.max_weight >> shift) < WEIGHT_CODE_MAX
+                       ? (config.max_weight >> shift) : WEIGHT_CODE_MAX;
+    reset = true;
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    reset = false;
+    init_weights(weight_memory, MAX_SYNAPSES, 0);
+    row_scale[4] = shift;
+    weight_memory[4 * MAX_NEURONS + 9] = WEIGHT_CODE_MIN;
+    
+    // A delta of one scale step moves the code by exactly one
+    update.pre_id = 4;
+    update.post_id = 8;
+    update.delta = 1 << shift;
+    update.timestamp = 10;
+    updates_in.write(update);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    
+    weight_code_t step_code = weight_memory[4 * MAX_NEURONS + 8];
+    if (step_code == 1 && dequantize_weight(step_code, row_scale[4]) == (1 << shift)) {
+        cout << "PASS: One scale step stored as code 1 (weight " << (1 << shift) << ")\n";
+    } else {
+        cout << "FAIL: Scale step stored as code " << step_code << "\n";
+        total_errors++;
+    }
+    
+    // Bounds are configured in weight units and clamp in code units
+    update.delta = 127;
+    updates_in.write(update);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    
+    if (weight_memory[4 * MAX_NEURONS + 8] == max_code) {
+        cout << "PASS: Scaled bound clamps at code " << max_code << "\n";
+    } else {
+        cout << "FAIL: Code " << weight_memory[4 * MAX_NEURONS + 8] << ", expected "
+             << max_code << "\n";
+        total_errors++;
+    }
+    
+    // One epoch at ~50% retention halves both codes towards zero
+    config.enable_decay = true;
+    config.decay_rate = 127;
+    update.delta = 0;
+    update.timestamp = 11;
+    updates_in.write(update);
+    run_updater(enable, reset, updates_in, weight_memory, config, updates_applied);
+    config.enable_decay = false;
+    row_scale[4] = 0;
+    
+    if (weight_memory[4 * MAX_NEURONS + 8] == max_code / 2 &&
+        weight_memory[4 * MAX_NEURONS + 9] == WEIGHT_CODE_MIN / 2) {
+        cout << "PASS: Codes decayed to " << max_code / 2 << " and " << WEIGHT_CODE_MIN / 2 << "\n";
+    } else {
+        cout << "FAIL: Decayed codes " << weight_memory[4 * MAX_NEURONS + 8] << " and "
+             << weight_memory[4 * MAX_NEURONS + 9] << ", expected " << max_code / 2
+             << " and " << WEIGHT_CODE_MIN / 2 << "\n";
+        total_errors++;
+    }
+    
     //-------------------------------------------------------------------------
     // Test Summary
     //-------------------------------------------------------------------------
     cout << "\n==============================================\n";
     cout << "Test Summary\n";
     cout << "==============================================\n";
-    cout << "Total Tests: 7\n";
+    cout << "Total Tests: 11\n";
     cout << "Errors: " << total_errors << "\n";
     
     if (total_errors == 0) {
@@ -98,10 +98,46 @@ set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_b
 set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces M_AXIS_SPIKE -of_objects [ipx::current_core]]
 set_property interface_mode master [ipx::get_bus_interfaces M_AXIS_SPIKE -of_objects [ipx::current_core]]
 
+ipx::add_bus_interface S_AXIS_LOAD [ipx::current_core]
+set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_bus_interfaces S_AXIS_LOAD -of_objects [ipx::current_core]]
+set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces S_AXIS_LOAD -of_objects [ipx::current_core]]
+set_property interface_mode slave [ipx::get_bus_interfaces S_AXIS_LOAD -of_objects [ipx::current_core]]
+
+ipx::add_bus_interface M_AXIS_STATE [ipx::current_core]
+set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_bus_interfaces M_AXIS_STATE -of_objects [ipx::current_core]]
+set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces M_AXIS_STATE -of_objects [ipx::current_core]]
+set_property interface_mode master [ipx::get_bus_interfaces M_AXIS_STATE -of_objects [ipx::current_core]]
+
+ipx::add_bus_interface M_AXIS_PAGE_CMD [ipx::current_core]
+set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_bus_interfaces M_AXIS_PAGE_CMD -of_objects [ipx::current_core]]
+set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces M_AXIS_PAGE_CMD -of_objects [ipx::current_core]]
+set_property interface_mode master [ipx::get_bus_interfaces M_AXIS_PAGE_CMD -of_objects [ipx::current_core]]
+
+ipx::add_bus_interface S_AXIS_PAGE [ipx::current_core]
+set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_bus_interfaces S_AXIS_PAGE -of_objects [ipx::current_core]]
+set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces S_AXIS_PAGE -of_objects [ipx::current_core]]
+set_property interface_mode slave [ipx::get_bus_interfaces S_AXIS_PAGE -of_objects [ipx::current_core]]
+
+ipx::add_bus_interface S_AXIS_AER [ipx::current_core]
+set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_bus_interfaces S_AXIS_AER -of_objects [ipx::current_core]]
+set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces S_AXIS_AER -of_objects [ipx::current_core]]
+set_property interface_mode slave [ipx::get_bus_interfaces S_AXIS_AER -of_objects [ipx::current_core]]
+
+ipx::add_bus_interface M_AXIS_AER [ipx::current_core]
+set_property abstraction_type_vlnv xilinx.com:interface:axis_rtl:1.0 [ipx::get_bus_interfaces M_AXIS_AER -of_objects [ipx::current_core]]
+set_property bus_type_vlnv xilinx.com:interface:axis:1.0 [ipx::get_bus_interfaces M_AXIS_AER -of_objects [ipx::current_core]]
+set_property interface_mode master [ipx::get_bus_interfaces M_AXIS_AER -of_objects [ipx::current_core]]
+
 # Associate clocks
 ipx::associate_bus_interfaces -busif S_AXI -clock aclk [ipx::current_core]
 ipx::associate_bus_interfaces -busif S_AXIS_SPIKE -clock aclk [ipx::current_core]
 ipx::associate_bus_interfaces -busif M_AXIS_SPIKE -clock aclk [ipx::current_core]
+ipx::associate_bus_interfaces -busif S_AXIS_LOAD -clock aclk [ipx::current_core]
+ipx::associate_bus_interfaces -busif M_AXIS_STATE -clock aclk [ipx::current_core]
+ipx::associate_bus_interfaces -busif M_AXIS_PAGE_CMD -clock aclk [ipx::current_core]
+ipx::associate_bus_interfaces -busif S_AXIS_PAGE -clock aclk [ipx::current_core]
+ipx::associate_bus_interfaces -busif S_AXIS_AER -clock aclk [ipx::current_core]
+ipx::associate_bus_interfaces -busif M_AXIS_AER -clock aclk [ipx::current_core]
 
 # Add memory maps
 ipx::add_memory_map S_AXI [ipx::current_core]